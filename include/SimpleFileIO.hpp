@@ -4,7 +4,9 @@
 #define _GNU_SOURCE
 #endif
 
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <stdexcept>
 #include <cstdio>
@@ -12,6 +14,94 @@
 #include <cstring>
 #include <filesystem>
 #include <algorithm>
+#include <charconv>
+#include <type_traits>
+#include <expected>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <bit>
+#include <utility>
+#include <system_error>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+
+#include <cerrno>
+#include <cstddef>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+/**
+ * @brief 1 when TextWriter::print / println are available, otherwise 0.
+ *
+ * They need a standard library implementing <format> (libstdc++ 13+,
+ * libc++ 17+, MSVC 19.29+). With older ones, e.g. GCC 12, the two members
+ * are not declared; test this macro instead of guessing from the compiler.
+ */
+#if defined(__cpp_lib_format)
+#define SFIO_HAS_PRINT 1
+#else
+#define SFIO_HAS_PRINT 0
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <sys/inotify.h>
+#endif
+
+#if defined(_WIN32)
+#include <io.h>
+#endif
+
+#if defined(__SSE2__) || defined(__AVX2__) || defined(__PCLMUL__) || defined(__SSE4_2__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// CRC32C kernels compiled for the CRC instructions and picked at run time
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SFIO_CRC32C_HARDWARE 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__ARM_FEATURE_CRC32) || defined(__linux__))
+#define SFIO_CRC32C_HARDWARE 1
+#include <arm_acle.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#endif
+
+// Optional compression layers, enabled by the build when the library is found
+#if defined(SFIO_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(SFIO_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+#if defined(SFIO_HAVE_LZ4)
+#include <lz4.h>
+#include <lz4frame.h>
+#endif
 
 /**
  * @defgroup Core Core Utilities
@@ -36,8 +126,12 @@
  *
  * Provides optimized text and binary readers/writers with explicit buffering,
  * portable fast I/O wrappers, and structured error handling via exceptions.
+ * Hot paths additionally offer non-throwing try* variants returning
+ * std::expected<T, IOError>; messages are only formatted on demand via
+ * formatIOError().
  *
- * @note All classes use manual 1 MB buffers to reduce syscall overhead.
+ * @note All classes use manual buffers (1 MB by default, drawn from a
+ *       thread-local BufferPool) to reduce syscall overhead.
  * @warning These utilities are not thread-safe on the same file instance.
  */
 namespace SimpleFileIO {
@@ -60,7 +154,8 @@ namespace SimpleFileIO {
         FileNotFound,
         PermissionDenied,
         ReadError,
-        WriteError
+        WriteError,
+        EndOfFile  ///< Reported only by the non-throwing try* API
     };
 
     
@@ -118,564 +213,6012 @@ namespace SimpleFileIO {
             case IOError::WriteError:
                 return "Low-level write error" + 
                         (detail.empty() ? "" : (": " + detail));
+            case IOError::EndOfFile:
+                return "End of file reached: " + path;
             default:
                 return "Unknown I/O error.";
         }
     }
 
     /**
-     * @ingroup TextIO
-     * @class TextReader
-     * @brief High-performance buffered text file reader.
+     * @ingroup Core
+     * @brief Default size of the per-instance I/O buffer (1 MB).
+     */
+    inline constexpr size_t DefaultBufferSize = 1 << 20;
+
+    /**
+     * @ingroup Core
+     * @brief Smallest buffer handed out by the BufferPool (4 KB).
+     */
+    inline constexpr size_t MinBufferSize = 4 << 10;
+
+    /**
+     * @ingroup Core
+     * @class BasicBufferPool
+     * @brief Thread-local cache of uninitialized, recyclable I/O buffers.
      *
-     * Optimized for sequential access using a manual 1 MB buffer.
+     * Readers and writers acquire their working buffer from the pool of the
+     * calling thread and hand it back on destruction. Buffers are never
+     * zero-filled, so opening a file costs at most one allocation and usually
+     * none at all once the pool is warm.
      *
-     * @note Newlines are normalized as-is; no CRLF conversion is performed.
+     * @tparam Allocator Allocator used for the blocks (rebound to char). It
+     *         must be default-constructible; each thread owns one instance.
+     *
+     * @note Requested sizes are rounded up to a power of two (minimum
+     *       MinBufferSize) so that recycled blocks can be matched exactly.
+     * @note A buffer is only recycled by the pool that handed it out; one
+     *       released on another thread is freed instead, so NUMA-bound
+     *       blocks never migrate to a thread on a different node.
      */
-    class TextReader {
+    template<typename Allocator = std::allocator<char>>
+    class BasicBufferPool {
     public:
-        /**
-         * @brief Opens a text file for reading.
-         * @param path Path to the file
-         * @throws IOException if the file cannot be opened
-         */
-        inline TextReader(const std::string& path);
-        
-        /**
-         * @brief Closes the file and releases resources.
-         */
-        inline ~TextReader();
+        using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<char>;
 
         /**
-         * @brief Checks whether a file exists.
-         * @param path Path to the file
-         * @return True if the file exists
+         * @class Buffer
+         * @brief Move-only owner of a pooled block; returns it on destruction.
          */
-        inline static bool exists(const std::string& path);
+        class Buffer {
+        public:
+            Buffer() = default;
+            Buffer(char* data, size_t size, BasicBufferPool* pool) : ptr(data), length(size), owner(pool) {}
+            Buffer(Buffer&& other) noexcept
+                : ptr(std::exchange(other.ptr, nullptr)),
+                  length(std::exchange(other.length, 0)),
+                  owner(std::exchange(other.owner, nullptr)) {}
+            Buffer& operator=(Buffer&& other) noexcept {
+                if (this != &other) {
+                    reset();
+                    ptr = std::exchange(other.ptr, nullptr);
+                    length = std::exchange(other.length, 0);
+                    owner = std::exchange(other.owner, nullptr);
+                }
+                return *this;
+            }
+            Buffer(const Buffer&) = delete;
+            Buffer& operator=(const Buffer&) = delete;
+            ~Buffer() { reset(); }
+
+            char* data() noexcept { return ptr; }
+            const char* data() const noexcept { return ptr; }
+            size_t size() const noexcept { return length; }
+            char& operator[](size_t i) noexcept { return ptr[i]; }
+            const char& operator[](size_t i) const noexcept { return ptr[i]; }
+
+        private:
+            void reset() noexcept {
+                if (!ptr) return;
+                BasicBufferPool::release(ptr, length, owner);
+                ptr = nullptr;
+                length = 0;
+                owner = nullptr;
+            }
+
+            char* ptr = nullptr;
+            size_t length = 0;
+            BasicBufferPool* owner = nullptr; // pool that handed the block out
+        };
 
         /**
-         * @brief Reads the entire file into a string.
-         *
-         * @return String containing all file contents
-         *
-         * @throws IOException on read failure
-         *
-         * @complexity Time: O(n)  
-         * @complexity Space: O(n)
-         */
-        inline std::string readString();
-        
-        /**
-         * @brief Reads a single line from the file.
-         *
-         * The returned string does not include the trailing newline.
-         *
-         * @return The next line, or an empty string on EOF
-         *
-         * @throws IOException on read failure
-         *
-         * @complexity Amortized O(k), where k is line length
+         * @brief Returns the pool owned by the calling thread.
          */
-        inline std::string readLine();
+        inline static BasicBufferPool& local();
 
         /**
-         * @brief Reads multiple lines from the file.
-         *
-         * @param numLines Maximum number of lines to read.
-         *                 If zero, reads until EOF.
-         * @return Vector containing the read lines
-         *
-         * @throws IOException on read failure
+         * @brief Hands out an uninitialized buffer of at least @p size bytes.
          *
-         * @complexity Time: O(n)  
-         * @complexity Space: O(n)
+         * @param size Requested size in bytes
+         * @return Buffer whose size() is @p size rounded up to a power of two
          */
-        inline std::vector<std::string> readLines(int numLines = 0);
+        inline Buffer acquire(size_t size);
+
+        inline ~BasicBufferPool();
 
     private:
-        FILE* file = nullptr;
-        std::string path;
+        static constexpr size_t MaxCachedBlocks = 8;
 
-        std::vector<char> buffer; // 1MB buffer
-        size_t cursor = 0;        // current position in buffer
-        size_t bufferEnd = 0;     // end of valid data in buffer
+        inline static bool& destroyed() noexcept;
+        inline static size_t sizeClass(size_t size) noexcept;
+        inline static void release(char* data, size_t size, BasicBufferPool* owner) noexcept;
+
+        allocator_type alloc;
+        std::vector<std::pair<char*, size_t>> blocks;
     };
 
-    inline TextReader::TextReader(const std::string& p)
-        : path(p)
-    {
-        // Open the file in text read mode
-        file = std::fopen(path.c_str(), "r");
-        if (!file) {
-            IOError code;
-            switch (errno) {
-                case ENOENT: // No such file or directory
-                    code = IOError::FileNotFound;
-                    break;
-                case EACCES: // Permission denied
-                    code = IOError::PermissionDenied;
-                    break;
-                default:
-                    code = IOError::FileNotOpen;
-            }
-            throw IOException(code, formatIOError(code, path), path);
-        }
+    /**
+     * @ingroup Core
+     * @brief Buffer pool backed by the standard allocator.
+     */
+    using BufferPool = BasicBufferPool<>;
 
-        // Allocate per-file 1 MB buffer for manual buffered reads
-        buffer.resize(1 << 20);
+    template<typename Allocator>
+    inline BasicBufferPool<Allocator>& BasicBufferPool<Allocator>::local() {
+        thread_local BasicBufferPool pool;
+        return pool;
     }
 
-    inline TextReader::~TextReader() {
-        if (!file) return;
-        std::fclose(file);
+    template<typename Allocator>
+    inline bool& BasicBufferPool<Allocator>::destroyed() noexcept {
+        // Trivially destructible, so it stays valid after the pool itself is gone
+        thread_local bool flag = false;
+        return flag;
     }
 
-    inline bool TextReader::exists(const std::string& path) {
-        return std::filesystem::exists(path);
+    template<typename Allocator>
+    inline size_t BasicBufferPool<Allocator>::sizeClass(size_t size) noexcept {
+        return std::bit_ceil(std::max(size, MinBufferSize));
     }
 
-    inline std::string TextReader::readString() {
-        if (!file) 
-            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
-
-        std::string result;
-        result.reserve(4 << 20); // start with 4 MB, grows dynamically if needed
+    template<typename Allocator>
+    inline typename BasicBufferPool<Allocator>::Buffer BasicBufferPool<Allocator>::acquire(size_t size) {
+        size_t wanted = sizeClass(size);
+        for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+            if (it->second == wanted) {
+                char* data = it->first;
+                blocks.erase(std::next(it).base());
+                return Buffer(data, wanted, this);
+            }
+        }
+        return Buffer(std::allocator_traits<allocator_type>::allocate(alloc, wanted), wanted, this);
+    }
 
-        while (true) {
-            size_t bytesRead = SFIO_FREAD(buffer.data(), 1, buffer.size(), file);
-            if (bytesRead == 0) {
-                if (ferror(file))
-                    throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
-                break;
+    template<typename Allocator>
+    inline void BasicBufferPool<Allocator>::release(char* data, size_t size, BasicBufferPool* owner) noexcept {
+        // Buffers outliving the thread's pool (e.g. static objects) or
+        // released on a thread other than the one that acquired them are
+        // freed directly
+        if (!destroyed() && owner == &local()) {
+            BasicBufferPool& pool = local();
+            if (pool.blocks.size() < MaxCachedBlocks) {
+                try {
+                    pool.blocks.emplace_back(data, size);
+                    return;
+                } catch (...) {}
             }
-            result.append(buffer.data(), bytesRead);
+            std::allocator_traits<allocator_type>::deallocate(pool.alloc, data, size);
+            return;
         }
-        return result;
+        allocator_type alloc;
+        std::allocator_traits<allocator_type>::deallocate(alloc, data, size);
     }
 
-    inline std::string TextReader::readLine() {
-        if (!file) 
-            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+    template<typename Allocator>
+    inline BasicBufferPool<Allocator>::~BasicBufferPool() {
+        destroyed() = true;
+        for (auto& block : blocks)
+            std::allocator_traits<allocator_type>::deallocate(alloc, block.first, block.second);
+    }
 
-        std::string line;
-        bool anyDataRead = false;
+    /**
+     * @ingroup Core
+     * @brief Placement options for MappedAllocator.
+     */
+    enum MappedMemory : unsigned {
+        MapDefault   = 0,      ///< Plain anonymous mapping
+        MapHugePages = 1 << 0, ///< MAP_HUGETLB, falling back to transparent huge pages (2 MB and up)
+        MapNumaLocal = 1 << 1  ///< Bind pages to the NUMA node of the allocating thread
+    };
 
-        while (true) {
-            if (cursor >= bufferEnd) {
-                // refill buffer
-                size_t leftover = bufferEnd - cursor;
-                if (leftover > 0) {
-                    std::memmove(buffer.data(), buffer.data() + cursor, leftover);
-                }
-                size_t bytesRead = SFIO_FREAD(buffer.data() + leftover, 1, buffer.size() - leftover, file);
-                cursor = 0;
-                bufferEnd = leftover + bytesRead;
+    namespace detail {
+        inline constexpr size_t HugePageSize = 2 << 20;
+        inline constexpr size_t PageSize = 4 << 10;
 
-                if (bytesRead == 0) {
-                    if (ferror(file))
-                        throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
-                    break; // normal EOF
-                }
-            }
+        /**
+         * @brief Whether a request of @p bytes goes to huge pages.
+         *
+         * Smaller requests (e.g. the pool's small size classes) would waste
+         * most of a 2 MB page, so they get normal pages.
+         */
+        inline bool hugePaged(size_t bytes, unsigned options) noexcept {
+            return (options & MapHugePages) && bytes >= HugePageSize;
+        }
 
-            size_t start = cursor;
-            while (cursor < bufferEnd && buffer[cursor] != '\n') cursor++;
-            if (cursor > start) {
-                line.append(buffer.data() + start, cursor - start);
-                anyDataRead = true;
-            }
+        inline size_t mappedSize(size_t bytes, unsigned options) noexcept {
+            size_t granule = hugePaged(bytes, options) ? HugePageSize : PageSize;
+            return (bytes + granule - 1) / granule * granule;
+        }
 
-            if (cursor < bufferEnd && buffer[cursor] == '\n') {
-                cursor++; // skip newline
-                break;
-            }
+        /**
+         * @brief Binds [addr, addr + bytes) to the NUMA node of the calling thread.
+         *
+         * Uses the raw mbind syscall so no libnuma dependency is required;
+         * failures (e.g. kernels without NUMA support) leave the default policy.
+         */
+        inline void bindToLocalNode(void* addr, size_t bytes) noexcept {
+        #if defined(__linux__) && defined(SYS_mbind) && defined(SYS_getcpu)
+            unsigned cpu = 0, node = 0;
+            if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return;
+            constexpr int MpolBind = 2; // MPOL_BIND from <numaif.h>
+            constexpr size_t MaskBits = 8 * sizeof(unsigned long);
+            unsigned long mask[16] = {};
+            if (node >= MaskBits * 16) return;
+            mask[node / MaskBits] = 1UL << (node % MaskBits);
+            syscall(SYS_mbind, addr, bytes, MpolBind, mask, MaskBits * 16, 0);
+        #else
+            (void)addr; (void)bytes;
+        #endif
         }
 
-        if (!anyDataRead && std::feof(file))
-            return {}; // EOF reached, return empty string without throwing
+        inline void* mapMemory(size_t bytes, unsigned options) {
+        #if defined(__linux__)
+            size_t length = mappedSize(bytes, options);
+            const bool huge = hugePaged(bytes, options);
+            void* p = MAP_FAILED;
+            if (huge)
+                p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p == MAP_FAILED) {
+                p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (p == MAP_FAILED) throw std::bad_alloc();
+                if (huge) ::madvise(p, length, MADV_HUGEPAGE);
+            }
+            // Bind before first touch so the pages are faulted in on the local node
+            if (options & MapNumaLocal) bindToLocalNode(p, length);
+            return p;
+        #else
+            (void)options;
+            return ::operator new(bytes);
+        #endif
+        }
 
-        return line;
+        inline void unmapMemory(void* p, size_t bytes, unsigned options) noexcept {
+        #if defined(__linux__)
+            ::munmap(p, mappedSize(bytes, options));
+        #else
+            (void)bytes; (void)options;
+            ::operator delete(p);
+        #endif
+        }
     }
 
-    inline std::vector<std::string> TextReader::readLines(int numLines) {
-        std::vector<std::string> lines;
-        if (numLines > 0) lines.reserve(numLines);
+    /**
+     * @ingroup Core
+     * @class MappedAllocator
+     * @brief Allocator placing buffers in anonymous mappings with huge-page
+     *        and/or NUMA-local placement.
+     *
+     * Intended as the Allocator argument of the reader/writer templates, e.g.
+     * `BasicByteReader<NumaLocalAllocator<char>>`. Because buffers are pooled
+     * per thread and never pre-touched, a buffer bound by a reader thread is
+     * faulted in on that thread's node.
+     *
+     * @tparam T       Value type
+     * @tparam Options Bitwise OR of MappedMemory flags
+     *
+     * @note Sizes are rounded up to the page granularity; with MapHugePages,
+     *       requests of 2 MB or more are rounded to and placed in huge pages.
+     *       On non-Linux platforms this behaves like operator new.
+     */
+    template<typename T, unsigned Options>
+    class MappedAllocator {
+    public:
+        using value_type = T;
 
-        while (numLines == 0 || lines.size() < static_cast<size_t>(numLines)) {
-            std::string line = readLine();
-            if (line.empty() && std::feof(file)) break; // stop at EOF
-            lines.push_back(std::move(line));
+        template<typename U>
+        struct rebind { using other = MappedAllocator<U, Options>; };
+
+        MappedAllocator() = default;
+        template<typename U>
+        MappedAllocator(const MappedAllocator<U, Options>&) noexcept {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(detail::mapMemory(n * sizeof(T), Options));
         }
 
-        return lines;
-    }
+        void deallocate(T* p, size_t n) noexcept {
+            detail::unmapMemory(p, n * sizeof(T), Options);
+        }
+
+        template<typename U>
+        bool operator==(const MappedAllocator<U, Options>&) const noexcept { return true; }
+    };
 
     /**
-     * @ingroup TextIO
-     * @class TextWriter
-     * @brief High-performance buffered text file writer.
-     *
-     * Uses chunked writes and a reusable internal buffer to minimize
-     * syscall overhead.
+     * @ingroup Core
+     * @brief Allocator backed by (transparent) huge pages.
      */
-    class TextWriter {
-    public:
-        /**
-         * @brief Opens a text file for writing.
-         * @param path   File path
-         * @param append Append instead of overwrite
-         * @throws IOException if the file cannot be opened
-         */
-        inline TextWriter(const std::string& path, bool append = false);
+    template<typename T>
+    using HugePageAllocator = MappedAllocator<T, MapHugePages>;
+
+    /**
+     * @ingroup Core
+     * @brief Allocator bound to the NUMA node of the allocating thread.
+     */
+    template<typename T>
+    using NumaLocalAllocator = MappedAllocator<T, MapNumaLocal>;
+
+    /**
+     * @ingroup Core
+     * @brief Huge-page allocator bound to the NUMA node of the allocating thread.
+     */
+    template<typename T>
+    using NumaHugePageAllocator = MappedAllocator<T, MapHugePages | MapNumaLocal>;
 
+    namespace detail {
         /**
-         * @brief Flushes buffers and closes the file.
+         * @brief Picks a read buffer size: never larger than the file itself.
          */
-        inline ~TextWriter();
+        inline size_t readBufferSize(const std::string& path, size_t requested) {
+            std::error_code ec;
+            auto fileSize = std::filesystem::file_size(path, ec);
+            if (ec) return requested;
+            return std::min(requested, static_cast<size_t>(fileSize));
+        }
 
         /**
-         * @brief Checks whether a file exists.
+         * @brief Size hint for whole-file reads, falling back to @p fallback.
          */
-        inline static bool exists(const std::string& path);
-        
+        inline size_t fileSizeHint(const std::string& path, size_t fallback) {
+            std::error_code ec;
+            auto fileSize = std::filesystem::file_size(path, ec);
+            return ec ? fallback : static_cast<size_t>(fileSize);
+        }
+
         /**
-         * @brief Flushes buffered output to disk.
+         * @brief Error category for a failed open, from its errno value.
          */
-        inline void flush();
+        inline IOError openError(int error) noexcept {
+            switch (error) {
+                case ENOENT: // No such file or directory
+                    return IOError::FileNotFound;
+                case EACCES: // Permission denied
+                    return IOError::PermissionDenied;
+                default:
+                    return IOError::FileNotOpen;
+            }
+        }
 
+    #if defined(__linux__)
         /**
-         * @brief Writes a raw string to the file.
-         *
-         * @complexity Time: O(n)  
-         * @complexity Space: O(1)
-         *
-         * @throws IOException on write failure
+         * @brief Syscall number of cachestat(2) (Linux 6.5+, same on every architecture).
          */
-        inline void writeString(const std::string& data);
-        
+        inline constexpr long CachestatSyscall = 451;
+
         /**
-         * @brief Writes a single line with a trailing newline.
-         *
-         * @throws IOException on write failure
+         * @brief Bytes per readahead(2) call in prefetch (the default block
+         *        device readahead window, so no call is trimmed).
          */
-        inline void writeLine(const std::string& line);
-        
+        inline constexpr uint64_t PrefetchWindow = 128 << 10;
+
         /**
-         * @brief Writes multiple lines to the file.
-         *
-         * @complexity Time: O(n)  
-         * @complexity Space: O(n)
-         *
-         * @throws IOException on write failure
+         * @brief Read-only descriptor closed on scope exit.
          */
-        inline void writeLines(const std::vector<std::string>& lines);
-
-    private:
-        FILE* file = nullptr;
-        std::string path;
-        bool append = false;
-        std::vector<char> buffer; // per-file 1MB buffer
-    };
-
-    inline TextWriter::TextWriter(const std::string& p, bool a)
-        : path(p), append(a)
-    {
-        const char* modeStr = append ? "a" : "w";
-        file = std::fopen(path.c_str(), modeStr);
-        if (!file)
-            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        struct ScopedDescriptor {
+            explicit ScopedDescriptor(const std::string& path) : fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC)) {
+                if (fd < 0)
+                    throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+            }
+            ~ScopedDescriptor() { ::close(fd); }
+            ScopedDescriptor(const ScopedDescriptor&) = delete;
+            ScopedDescriptor& operator=(const ScopedDescriptor&) = delete;
 
-        // Allocate per-file 1 MB buffer for assembling write payloads
-        buffer.resize(1 << 20);
-    }
+            int fd;
+        };
+    #endif
 
-    inline TextWriter::~TextWriter() {
-        if (!file) return;
-        std::fflush(file);
-        std::fclose(file);
-    }
+        /**
+         * @brief Page-cache residency of @p path (see BasicTextReader::cachedFraction).
+         */
+        inline double cachedFraction(const std::string& path) {
+        #if defined(__linux__)
+            ScopedDescriptor file(path);
+            struct stat info;
+            if (::fstat(file.fd, &info) != 0)
+                throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+            if (info.st_size == 0) return 1.0;
+            const auto size = static_cast<uint64_t>(info.st_size);
+            const auto page = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+            const uint64_t pages = (size + page - 1) / page;
 
-    inline bool TextWriter::exists(const std::string& path) {
-        return std::filesystem::exists(path);
-    }
+            // cachestat answers from the page cache without touching the file
+            struct { uint64_t offset, length; } range{0, 0}; // length 0: to EOF
+            struct { uint64_t cache, dirty, writeback, evicted, recentlyEvicted; } counts{};
+            if (::syscall(CachestatSyscall, file.fd, &range, &counts, 0) == 0)
+                return std::min(1.0, static_cast<double>(counts.cache) / static_cast<double>(pages));
 
-    inline void TextWriter::flush() {
-        if (!file) return;
-        std::fflush(file);
-    }
+            // Older kernels: mincore over a mapping that is never touched
+            void* map = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file.fd, 0);
+            if (map == MAP_FAILED)
+                throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+            std::vector<unsigned char> resident(pages);
+            int status = ::mincore(map, size, resident.data());
+            ::munmap(map, size);
+            if (status != 0)
+                throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+            uint64_t cached = 0;
+            for (unsigned char flags : resident) cached += flags & 1;
+            return static_cast<double>(cached) / static_cast<double>(pages);
+        #else
+            if (!std::filesystem::exists(path))
+                throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+            return 0.0; // residency unknown: report the file as cold
+        #endif
+        }
 
-    inline void TextWriter::writeString(const std::string& data) {
-        // chunked write to avoid issues with extremely large strings
-        const size_t chunkSize = 1 << 20;
-        size_t offset = 0;
-        while (offset < data.size()) {
-            size_t toWrite = std::min(chunkSize, data.size() - offset);
-            size_t written = SFIO_FWRITE(data.data() + offset, 1, toWrite, file);
-            if (written != toWrite)
-                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write string to file."), path);
-            offset += written;
+        /**
+         * @brief Queues reads of a byte range of @p path (see BasicTextReader::prefetch).
+         */
+        inline void prefetch(const std::string& path, uint64_t offset, uint64_t length) {
+        #if defined(__linux__)
+            ScopedDescriptor file(path);
+            struct stat info;
+            if (::fstat(file.fd, &info) != 0)
+                throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+            const auto size = static_cast<uint64_t>(info.st_size);
+            if (offset >= size) return;
+            const uint64_t end = offset + std::min(length, size - offset);
+            // readahead(2) queues the reads and returns, but the kernel
+            // trims each call to the device's readahead window, so walk the
+            // range in window-sized steps. WILLNEED covers files readahead
+            // refuses (e.g. some network filesystems).
+            for (uint64_t at = offset; at < end; at += PrefetchWindow) {
+                auto step = static_cast<size_t>(std::min<uint64_t>(PrefetchWindow, end - at));
+                if (::readahead(file.fd, static_cast<off64_t>(at), step) != 0)
+                    ::posix_fadvise(file.fd, static_cast<off_t>(at), static_cast<off_t>(step), POSIX_FADV_WILLNEED);
+            }
+        #elif defined(POSIX_FADV_WILLNEED)
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+            ::posix_fadvise(fd, static_cast<off_t>(offset),
+                            static_cast<off_t>(std::min<uint64_t>(length, std::numeric_limits<off_t>::max())),
+                            POSIX_FADV_WILLNEED);
+            ::close(fd);
+        #else
+            (void)offset; (void)length;
+            if (!std::filesystem::exists(path))
+                throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        #endif
         }
     }
 
-    inline void TextWriter::writeLine(const std::string& line) {
-        if (!file)
-            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
-
-        // Use single preallocated buffer per TextWriter
-        buffer.clear();
-        buffer.insert(buffer.end(), line.begin(), line.end());
-        buffer.push_back('\n');
-        size_t written = SFIO_FWRITE(buffer.data(), 1, buffer.size(), file);
-        if (written != buffer.size())
-            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write line to file."), path);
-    }
+    /**
+     * @ingroup Core
+     * @brief Backend selection.
+     *
+     * On POSIX systems files are accessed through raw file descriptors
+     * (open/read/write/pread/pwrite), so data moves straight between the
+     * kernel and our own buffers. Define SFIO_USE_STDIO to force the portable
+     * stdio backend; it is selected automatically on non-POSIX platforms.
+     */
+    #if !defined(SFIO_USE_STDIO) && !(defined(__unix__) || defined(__APPLE__))
+    #define SFIO_USE_STDIO
+    #endif
 
-    inline void TextWriter::writeLines(const std::vector<std::string>& lines) {
+    /**
+     * @ingroup Core
+     * @enum Compression
+     * @brief Compression layer placed between a reader/writer and its file.
+     *
+     * Gzip requires zlib (SFIO_HAVE_ZLIB), Zstd requires libzstd
+     * (SFIO_HAVE_ZSTD) and Lz4 requires the lz4 frame library
+     * (SFIO_HAVE_LZ4). The CMake build defines these when the libraries
+     * are found; requesting a format that is not compiled in throws.
+     */
+    enum class Compression {
+        None,
+        Auto,  ///< Readers detect the format by magic bytes, writers by file extension
+        Gzip,
+        Zstd,
+        Lz4
+    };
+
+    /**
+     * @ingroup Core
+     * @enum Checksum
+     * @brief Digest computed inline over the bytes a reader returns or a writer accepts.
+     *
+     * CRC32C uses the SSE4.2 crc32 instruction (or the ARMv8 CRC extension)
+     * when the CPU has it, detected at run time, and a slicing-by-8 table
+     * otherwise. XxHash64 is the non-cryptographic 64-bit xxHash.
+     */
+    enum class Checksum {
+        None,
+        Crc32c,   ///< 4-byte digest
+        XxHash64  ///< 8-byte digest
+    };
+
+    namespace detail {
+        enum class OpenMode { Read, Write, Append };
+
+        /**
+         * @brief Owning handle over a file descriptor or, as a fallback, a FILE*.
+         *
+         * read/pread return the number of bytes transferred, 0 on EOF and -1
+         * on error (errno is set). Interrupted calls are retried.
+         */
+        class FileHandle {
+        public:
+            FileHandle() = default;
+            FileHandle(FileHandle&& other) noexcept { swap(other); }
+            FileHandle& operator=(FileHandle&& other) noexcept {
+                if (this != &other) { close(); swap(other); }
+                return *this;
+            }
+            FileHandle(const FileHandle&) = delete;
+            FileHandle& operator=(const FileHandle&) = delete;
+            ~FileHandle() { close(); }
+
+            inline static FileHandle open(const std::string& path, OpenMode mode, bool binary);
+
+            explicit operator bool() const noexcept {
+            #if defined(SFIO_USE_STDIO)
+                return file != nullptr;
+            #else
+                return fd >= 0;
+            #endif
+            }
+
+            inline ptrdiff_t read(char* dst, size_t n) noexcept;
+            inline ptrdiff_t pread(char* dst, size_t n, uint64_t offset) noexcept;
+            inline bool write(const char* src, size_t n) noexcept;
+            inline bool pwrite(const char* src, size_t n, uint64_t offset) noexcept;
+            inline bool seek(uint64_t offset) noexcept;
+            inline bool flush() noexcept;
+            inline void close() noexcept;
+
+            /**
+             * @brief Underlying descriptor (-1 if unavailable).
+             */
+            inline int native() const noexcept;
+
+        private:
+            void swap(FileHandle& other) noexcept {
+            #if defined(SFIO_USE_STDIO)
+                std::swap(file, other.file);
+            #else
+                std::swap(fd, other.fd);
+            #endif
+            }
+
+        #if defined(SFIO_USE_STDIO)
+            FILE* file = nullptr;
+        #else
+            int fd = -1;
+        #endif
+        };
+
+    #if defined(SFIO_USE_STDIO)
+        inline FileHandle FileHandle::open(const std::string& path, OpenMode mode, bool binary) {
+            static const char* modes[2][3] = {{"r", "w", "a"}, {"rb", "wb", "ab"}};
+            FileHandle handle;
+            handle.file = std::fopen(path.c_str(), modes[binary ? 1 : 0][static_cast<int>(mode)]);
+            // We do our own buffering; an unbuffered FILE avoids the extra stdio copy.
+            // Never hand our own buffer to setvbuf(): it would alias the read/write source.
+            if (handle.file) std::setvbuf(handle.file, nullptr, _IONBF, 0);
+            return handle;
+        }
+
+        inline ptrdiff_t FileHandle::read(char* dst, size_t n) noexcept {
+            size_t got = SFIO_FREAD(dst, 1, n, file);
+            if (got == 0 && std::ferror(file)) return -1;
+            return static_cast<ptrdiff_t>(got);
+        }
+
+        inline ptrdiff_t FileHandle::pread(char* dst, size_t n, uint64_t offset) noexcept {
+            // Emulated with seek + read; restores the position but is not thread-safe
+            long previous = std::ftell(file);
+            if (previous < 0 || std::fseek(file, static_cast<long>(offset), SEEK_SET) != 0) return -1;
+            ptrdiff_t got = read(dst, n);
+            std::fseek(file, previous, SEEK_SET);
+            return got;
+        }
+
+        inline bool FileHandle::write(const char* src, size_t n) noexcept {
+            return SFIO_FWRITE(src, 1, n, file) == n;
+        }
+
+        inline bool FileHandle::pwrite(const char* src, size_t n, uint64_t offset) noexcept {
+            long previous = std::ftell(file);
+            if (previous < 0 || std::fseek(file, static_cast<long>(offset), SEEK_SET) != 0) return false;
+            bool ok = write(src, n);
+            std::fseek(file, previous, SEEK_SET);
+            return ok;
+        }
+
+        inline bool FileHandle::seek(uint64_t offset) noexcept {
+            return std::fseek(file, static_cast<long>(offset), SEEK_SET) == 0;
+        }
+
+        inline bool FileHandle::flush() noexcept {
+            return std::fflush(file) == 0;
+        }
+
+        inline void FileHandle::close() noexcept {
+            if (file) std::fclose(file);
+            file = nullptr;
+        }
+
+        inline int FileHandle::native() const noexcept {
+            return -1;
+        }
+    #else
+        inline FileHandle FileHandle::open(const std::string& path, OpenMode mode, bool) {
+            static const int flags[3] = {
+                O_RDONLY,
+                O_WRONLY | O_CREAT | O_TRUNC,
+                O_WRONLY | O_CREAT | O_APPEND
+            };
+            FileHandle handle;
+            do {
+                handle.fd = ::open(path.c_str(), flags[static_cast<int>(mode)] | O_CLOEXEC, 0666);
+            } while (handle.fd < 0 && errno == EINTR);
+        #if defined(POSIX_FADV_SEQUENTIAL)
+            if (handle.fd >= 0 && mode == OpenMode::Read)
+                ::posix_fadvise(handle.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        #endif
+            return handle;
+        }
+
+        inline ptrdiff_t FileHandle::read(char* dst, size_t n) noexcept {
+            while (true) {
+                ssize_t got = ::read(fd, dst, n);
+                if (got >= 0 || errno != EINTR) return got;
+            }
+        }
+
+        inline ptrdiff_t FileHandle::pread(char* dst, size_t n, uint64_t offset) noexcept {
+            while (true) {
+                ssize_t got = ::pread(fd, dst, n, static_cast<off_t>(offset));
+                if (got >= 0 || errno != EINTR) return got;
+            }
+        }
+
+        inline bool FileHandle::write(const char* src, size_t n) noexcept {
+            while (n > 0) {
+                ssize_t put = ::write(fd, src, n);
+                if (put < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                src += put;
+                n -= static_cast<size_t>(put);
+            }
+            return true;
+        }
+
+        inline bool FileHandle::pwrite(const char* src, size_t n, uint64_t offset) noexcept {
+            while (n > 0) {
+                ssize_t put = ::pwrite(fd, src, n, static_cast<off_t>(offset));
+                if (put < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                src += put;
+                n -= static_cast<size_t>(put);
+                offset += static_cast<uint64_t>(put);
+            }
+            return true;
+        }
+
+        inline bool FileHandle::seek(uint64_t offset) noexcept {
+            return ::lseek(fd, static_cast<off_t>(offset), SEEK_SET) >= 0;
+        }
+
+        inline bool FileHandle::flush() noexcept {
+            return true; // no user-space buffering below us
+        }
+
+        inline void FileHandle::close() noexcept {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+
+        inline int FileHandle::native() const noexcept {
+            return fd;
+        }
+    #endif
+
+        /**
+         * @brief Reads until @p n bytes are transferred or EOF is reached.
+         * @return Bytes read, or -1 on error
+         */
+        inline ptrdiff_t readFull(FileHandle& file, char* dst, size_t n) noexcept {
+            size_t total = 0;
+            while (total < n) {
+                ptrdiff_t got = file.read(dst + total, n - total);
+                if (got < 0) return -1;
+                if (got == 0) break;
+                total += static_cast<size_t>(got);
+            }
+            return static_cast<ptrdiff_t>(total);
+        }
+
+        /**
+         * @brief Positional readFull: reads at @p offset until @p n bytes or EOF.
+         *
+         * Works on a FileHandle or a Stream; the file position is untouched.
+         *
+         * @return Bytes read, or -1 on error
+         */
+        template<typename Handle>
+        inline ptrdiff_t preadFull(Handle& file, char* dst, size_t n, uint64_t offset) noexcept {
+            size_t total = 0;
+            while (total < n) {
+                ptrdiff_t got = file.pread(dst + total, n - total, offset + total);
+                if (got < 0) return -1;
+                if (got == 0) break;
+                total += static_cast<size_t>(got);
+            }
+            return static_cast<ptrdiff_t>(total);
+        }
+
+        /**
+         * @brief Blocks until a (non-blocking) descriptor becomes writable.
+         */
+        inline void waitWritable(int fd) noexcept {
+        #if defined(__unix__) || defined(__APPLE__)
+            pollfd pfd{fd, POLLOUT, 0};
+            while (::poll(&pfd, 1, -1) < 0 && errno == EINTR) {}
+        #else
+            (void)fd;
+        #endif
+        }
+
+        /**
+         * @brief Writes all bytes to a raw descriptor, retrying short writes.
+         */
+        inline bool writeToDescriptor(int fd, const char* src, size_t n) noexcept {
+            while (n > 0) {
+            #if defined(_WIN32)
+                int put = ::_write(fd, src, static_cast<unsigned>(std::min<size_t>(n, 1 << 30)));
+            #else
+                ssize_t put = ::write(fd, src, n);
+            #endif
+                if (put < 0) {
+                    if (errno == EINTR) continue;
+                #if defined(__unix__) || defined(__APPLE__)
+                    if (errno == EAGAIN) { waitWritable(fd); continue; }
+                #endif
+                    return false;
+                }
+                src += put;
+                n -= static_cast<size_t>(put);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Size of the staging buffer each codec uses for encoded bytes.
+         */
+        inline constexpr size_t CodecChunkSize = 128 << 10;
+
+        /**
+         * @brief Streaming decoder or encoder sitting between a Stream and its file.
+         *
+         * read() behaves like FileHandle::read on the decoded data: 0 once the
+         * last frame has ended, -1 with errno = EIO on corrupt or truncated
+         * input. Concatenated frames/members are decoded as one stream.
+         */
+        class Codec {
+        public:
+            virtual ~Codec() = default;
+            virtual ptrdiff_t read(FileHandle& file, char* dst, size_t n) noexcept = 0;
+            virtual bool write(FileHandle& file, const char* src, size_t n) noexcept = 0;
+            virtual bool flush(FileHandle& file) noexcept = 0;  ///< Makes written data decodable
+            virtual bool finish(FileHandle& file) noexcept = 0; ///< Ends the stream
+        };
+
+    #if defined(SFIO_HAVE_ZLIB)
+        /**
+         * @brief gzip via zlib. Decoding also accepts zlib-wrapped data.
+         */
+        class GzipCodec final : public Codec {
+        public:
+            explicit GzipCodec(bool encode) : encoding(encode), chunk(new char[CodecChunkSize]) {
+                int rc = encoding
+                    ? deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY)
+                    : inflateInit2(&stream, 15 + 32);
+                initialized = rc == Z_OK;
+            }
+
+            ~GzipCodec() override {
+                if (!initialized) return;
+                if (encoding) deflateEnd(&stream);
+                else inflateEnd(&stream);
+            }
+
+            bool valid() const noexcept { return initialized; }
+
+            ptrdiff_t read(FileHandle& file, char* dst, size_t n) noexcept override {
+                n = std::min<size_t>(n, 1 << 30);
+                if (encoding || n == 0) return 0;
+                stream.next_out = reinterpret_cast<Bytef*>(dst);
+                stream.avail_out = static_cast<uInt>(n);
+
+                while (stream.avail_out == n) {
+                    // A full output buffer may leave decoded bytes pending in zlib
+                    if (stream.avail_in == 0 && !(inMember && flushing)) {
+                        ptrdiff_t got = file.read(chunk.get(), CodecChunkSize);
+                        if (got < 0) return -1;
+                        if (got == 0) {
+                            if (!inMember) return 0;
+                            errno = EIO; // truncated member
+                            return -1;
+                        }
+                        stream.next_in = reinterpret_cast<Bytef*>(chunk.get());
+                        stream.avail_in = static_cast<uInt>(got);
+                    }
+                    if (!inMember) {
+                        inflateReset(&stream);
+                        inMember = true;
+                    }
+                    int rc = inflate(&stream, Z_NO_FLUSH);
+                    flushing = stream.avail_out == 0;
+                    if (rc == Z_STREAM_END) {
+                        inMember = false;
+                    } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+                        errno = EIO;
+                        return -1;
+                    }
+                }
+                return static_cast<ptrdiff_t>(n - stream.avail_out);
+            }
+
+            bool write(FileHandle& file, const char* src, size_t n) noexcept override {
+                if (!encoding) return false;
+                while (n > 0) {
+                    size_t piece = std::min<size_t>(n, 1 << 30);
+                    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(src));
+                    stream.avail_in = static_cast<uInt>(piece);
+                    if (!deflateAll(file, Z_NO_FLUSH)) return false;
+                    src += piece;
+                    n -= piece;
+                }
+                return true;
+            }
+
+            bool flush(FileHandle& file) noexcept override {
+                return !encoding || deflateAll(file, Z_SYNC_FLUSH);
+            }
+
+            bool finish(FileHandle& file) noexcept override {
+                return !encoding || deflateAll(file, Z_FINISH);
+            }
+
+        private:
+            bool deflateAll(FileHandle& file, int mode) noexcept {
+                while (true) {
+                    stream.next_out = reinterpret_cast<Bytef*>(chunk.get());
+                    stream.avail_out = static_cast<uInt>(CodecChunkSize);
+                    int rc = deflate(&stream, mode);
+                    if (rc == Z_STREAM_ERROR) return false;
+                    size_t have = CodecChunkSize - stream.avail_out;
+                    if (have > 0 && !file.write(chunk.get(), have)) return false;
+                    if (mode == Z_FINISH ? rc == Z_STREAM_END : stream.avail_out != 0) return true;
+                }
+            }
+
+            z_stream stream{};
+            bool encoding;
+            bool initialized = false;
+            bool inMember = false;  // inside a gzip member (decoding)
+            bool flushing = false;  // last inflate filled the output buffer
+            std::unique_ptr<char[]> chunk;
+        };
+    #endif
+
+    #if defined(SFIO_HAVE_ZSTD)
+        /**
+         * @brief zstd streaming codec; compresses with one worker per core
+         *        when libzstd is built with multi-threading support.
+         */
+        class ZstdCodec final : public Codec {
+        public:
+            explicit ZstdCodec(bool encode) : encoding(encode), chunk(new char[CodecChunkSize]) {
+                if (!encoding) {
+                    dctx = ZSTD_createDCtx();
+                    return;
+                }
+                cctx = ZSTD_createCCtx();
+                if (!cctx) return;
+                ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT);
+                // Fails harmlessly (staying single-threaded) without ZSTD_MULTITHREAD
+                unsigned workers = std::thread::hardware_concurrency();
+                if (workers > 1) ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, static_cast<int>(workers));
+            }
+
+            ~ZstdCodec() override {
+                ZSTD_freeCCtx(cctx);
+                ZSTD_freeDCtx(dctx);
+            }
+
+            bool valid() const noexcept { return encoding ? cctx != nullptr : dctx != nullptr; }
+
+            ptrdiff_t read(FileHandle& file, char* dst, size_t n) noexcept override {
+                if (encoding || n == 0) return 0;
+                ZSTD_outBuffer out{dst, n, 0};
+
+                while (out.pos == 0) {
+                    // A full output buffer may leave decoded bytes pending in zstd
+                    if (input.pos == input.size && !(inFrame && flushing)) {
+                        ptrdiff_t got = file.read(chunk.get(), CodecChunkSize);
+                        if (got < 0) return -1;
+                        if (got == 0) {
+                            if (!inFrame) return 0;
+                            errno = EIO; // truncated frame
+                            return -1;
+                        }
+                        input = {chunk.get(), static_cast<size_t>(got), 0};
+                    }
+                    size_t hint = ZSTD_decompressStream(dctx, &out, &input);
+                    if (ZSTD_isError(hint)) {
+                        errno = EIO;
+                        return -1;
+                    }
+                    inFrame = hint != 0;
+                    flushing = out.pos == out.size;
+                }
+                return static_cast<ptrdiff_t>(out.pos);
+            }
+
+            bool write(FileHandle& file, const char* src, size_t n) noexcept override {
+                if (!encoding) return false;
+                ZSTD_inBuffer in{src, n, 0};
+                return compress(file, in, ZSTD_e_continue);
+            }
+
+            bool flush(FileHandle& file) noexcept override {
+                ZSTD_inBuffer in{nullptr, 0, 0};
+                return !encoding || compress(file, in, ZSTD_e_flush);
+            }
+
+            bool finish(FileHandle& file) noexcept override {
+                ZSTD_inBuffer in{nullptr, 0, 0};
+                return !encoding || compress(file, in, ZSTD_e_end);
+            }
+
+        private:
+            bool compress(FileHandle& file, ZSTD_inBuffer& in, ZSTD_EndDirective mode) noexcept {
+                while (true) {
+                    ZSTD_outBuffer out{chunk.get(), CodecChunkSize, 0};
+                    size_t remaining = ZSTD_compressStream2(cctx, &out, &in, mode);
+                    if (ZSTD_isError(remaining)) return false;
+                    if (out.pos > 0 && !file.write(chunk.get(), out.pos)) return false;
+                    if (mode == ZSTD_e_continue ? in.pos == in.size : remaining == 0) return true;
+                }
+            }
+
+            bool encoding;
+            ZSTD_CCtx* cctx = nullptr;
+            ZSTD_DCtx* dctx = nullptr;
+            ZSTD_inBuffer input{nullptr, 0, 0};
+            bool inFrame = false;   // inside a frame (decoding)
+            bool flushing = false;  // last call filled the output buffer
+            std::unique_ptr<char[]> chunk;
+        };
+    #endif
+
+    #if defined(SFIO_HAVE_LZ4)
+        /**
+         * @brief LZ4 frame format codec.
+         */
+        class Lz4Codec final : public Codec {
+        public:
+            explicit Lz4Codec(bool encode) : encoding(encode) {
+                if (encoding) {
+                    // Room for the frame header plus one worst-case CodecChunkSize update
+                    capacity = LZ4F_compressBound(CodecChunkSize, &preferences) + LZ4F_HEADER_SIZE_MAX;
+                    initialized = !LZ4F_isError(LZ4F_createCompressionContext(&cctx, LZ4F_VERSION));
+                } else {
+                    capacity = CodecChunkSize;
+                    initialized = !LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION));
+                }
+                chunk.reset(new char[capacity]);
+            }
+
+            ~Lz4Codec() override {
+                if (cctx) LZ4F_freeCompressionContext(cctx);
+                if (dctx) LZ4F_freeDecompressionContext(dctx);
+            }
+
+            bool valid() const noexcept { return initialized; }
+
+            ptrdiff_t read(FileHandle& file, char* dst, size_t n) noexcept override {
+                if (encoding || n == 0) return 0;
+                size_t produced = 0;
+
+                while (produced == 0) {
+                    // A full output buffer may leave decoded bytes pending in lz4
+                    if (inPos == inSize && !(inFrame && flushing)) {
+                        ptrdiff_t got = file.read(chunk.get(), capacity);
+                        if (got < 0) return -1;
+                        if (got == 0) {
+                            if (!inFrame) return 0;
+                            errno = EIO; // truncated frame
+                            return -1;
+                        }
+                        inPos = 0;
+                        inSize = static_cast<size_t>(got);
+                    }
+                    size_t dstSize = n;
+                    size_t srcSize = inSize - inPos;
+                    size_t hint = LZ4F_decompress(dctx, dst, &dstSize, chunk.get() + inPos, &srcSize, nullptr);
+                    if (LZ4F_isError(hint)) {
+                        errno = EIO;
+                        return -1;
+                    }
+                    inPos += srcSize;
+                    produced = dstSize;
+                    inFrame = hint != 0;
+                    flushing = dstSize == n;
+                }
+                return static_cast<ptrdiff_t>(produced);
+            }
+
+            bool write(FileHandle& file, const char* src, size_t n) noexcept override {
+                if (!encoding || !begin(file)) return false;
+                while (n > 0) {
+                    size_t piece = std::min(n, CodecChunkSize);
+                    size_t size = LZ4F_compressUpdate(cctx, chunk.get(), capacity, src, piece, nullptr);
+                    if (LZ4F_isError(size) || (size > 0 && !file.write(chunk.get(), size))) return false;
+                    src += piece;
+                    n -= piece;
+                }
+                return true;
+            }
+
+            bool flush(FileHandle& file) noexcept override {
+                if (!encoding) return true;
+                if (!begin(file)) return false;
+                size_t size = LZ4F_flush(cctx, chunk.get(), capacity, nullptr);
+                return !LZ4F_isError(size) && (size == 0 || file.write(chunk.get(), size));
+            }
+
+            bool finish(FileHandle& file) noexcept override {
+                if (!encoding) return true;
+                if (!begin(file)) return false;
+                size_t size = LZ4F_compressEnd(cctx, chunk.get(), capacity, nullptr);
+                started = false;
+                return !LZ4F_isError(size) && (size == 0 || file.write(chunk.get(), size));
+            }
+
+        private:
+            // The frame header is written lazily, on first use
+            bool begin(FileHandle& file) noexcept {
+                if (started) return true;
+                size_t size = LZ4F_compressBegin(cctx, chunk.get(), capacity, &preferences);
+                if (LZ4F_isError(size) || !file.write(chunk.get(), size)) return false;
+                started = true;
+                return true;
+            }
+
+            bool encoding;
+            bool initialized = false;
+            bool started = false;
+            bool inFrame = false;   // inside a frame (decoding)
+            bool flushing = false;  // last call filled the output buffer
+            LZ4F_preferences_t preferences{};
+            LZ4F_cctx* cctx = nullptr;
+            LZ4F_dctx* dctx = nullptr;
+            size_t capacity = 0;
+            size_t inPos = 0;
+            size_t inSize = 0;
+            std::unique_ptr<char[]> chunk;
+        };
+    #endif
+
+        /**
+         * @brief Detects a compression format from the first bytes of a file.
+         *
+         * Uses pread, so the file position is untouched; non-seekable inputs
+         * report Compression::None.
+         */
+        inline Compression detectCompression(FileHandle& file) noexcept {
+            unsigned char magic[4] = {};
+            ptrdiff_t got = file.pread(reinterpret_cast<char*>(magic), sizeof(magic), 0);
+            if (got >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+                return Compression::Gzip;
+            if (got == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+                return Compression::Zstd;
+            if (got == 4 && magic[0] == 0x04 && magic[1] == 0x22 && magic[2] == 0x4d && magic[3] == 0x18)
+                return Compression::Lz4;
+            return Compression::None;
+        }
+
+        /**
+         * @brief Picks a compression format from a file extension (.gz, .zst, .lz4).
+         */
+        inline Compression compressionForPath(const std::string& path) {
+            auto extension = std::filesystem::path(path).extension();
+            if (extension == ".gz") return Compression::Gzip;
+            if (extension == ".zst") return Compression::Zstd;
+            if (extension == ".lz4") return Compression::Lz4;
+            return Compression::None;
+        }
+
+        /**
+         * @brief Creates a codec, or nullptr if the format is not compiled in.
+         */
+        inline std::unique_ptr<Codec> makeCodec(Compression compression, [[maybe_unused]] bool encode) {
+            switch (compression) {
+            #if defined(SFIO_HAVE_ZLIB)
+                case Compression::Gzip: {
+                    auto codec = std::make_unique<GzipCodec>(encode);
+                    if (codec->valid()) return codec;
+                    break;
+                }
+            #endif
+            #if defined(SFIO_HAVE_ZSTD)
+                case Compression::Zstd: {
+                    auto codec = std::make_unique<ZstdCodec>(encode);
+                    if (codec->valid()) return codec;
+                    break;
+                }
+            #endif
+            #if defined(SFIO_HAVE_LZ4)
+                case Compression::Lz4: {
+                    auto codec = std::make_unique<Lz4Codec>(encode);
+                    if (codec->valid()) return codec;
+                    break;
+                }
+            #endif
+                default:
+                    break;
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief CRC32C (Castagnoli, reflected 0x82F63B78) slicing-by-8 tables.
+         */
+        struct Crc32cTables {
+            uint32_t table[8][256];
+
+            constexpr Crc32cTables() : table{} {
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t crc = i;
+                    for (int bit = 0; bit < 8; ++bit)
+                        crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+                    table[0][i] = crc;
+                }
+                for (uint32_t i = 0; i < 256; ++i)
+                    for (int t = 1; t < 8; ++t)
+                        table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xFF];
+            }
+        };
+
+        inline constexpr Crc32cTables crc32cTables{};
+
+        inline uint64_t loadU64LE(const char* p) noexcept {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            if constexpr (std::endian::native == std::endian::big) v = std::byteswap(v);
+            return v;
+        }
+
+        inline uint32_t loadU32LE(const char* p) noexcept {
+            uint32_t v;
+            std::memcpy(&v, p, 4);
+            if constexpr (std::endian::native == std::endian::big) v = std::byteswap(v);
+            return v;
+        }
+
+        /**
+         * @brief Table-driven CRC32C; the portable fallback.
+         */
+        inline uint32_t crc32cSoftware(uint32_t crc, const unsigned char* p, size_t n) noexcept {
+            const auto& t = crc32cTables.table;
+            for (; n >= 8; n -= 8, p += 8) {
+                uint64_t v = loadU64LE(reinterpret_cast<const char*>(p)) ^ crc;
+                crc = t[7][v & 0xFF] ^ t[6][(v >> 8) & 0xFF] ^ t[5][(v >> 16) & 0xFF] ^ t[4][(v >> 24) & 0xFF]
+                    ^ t[3][(v >> 32) & 0xFF] ^ t[2][(v >> 40) & 0xFF] ^ t[1][(v >> 48) & 0xFF] ^ t[0][v >> 56];
+            }
+            for (; n > 0; --n) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+            return crc;
+        }
+
+        // The hardware kernels are compiled for the CRC extension whatever the
+        // build targets and are only called once the CPU is known to have it
+    #if defined(SFIO_CRC32C_HARDWARE) && defined(__x86_64__)
+        __attribute__((target("sse4.2")))
+        inline uint32_t crc32cHardware(uint32_t crc, const unsigned char* p, size_t n) noexcept {
+            uint64_t wide = crc;
+            for (; n >= 8; n -= 8, p += 8)
+                wide = _mm_crc32_u64(wide, loadU64LE(reinterpret_cast<const char*>(p)));
+            crc = static_cast<uint32_t>(wide);
+            for (; n > 0; --n) crc = _mm_crc32_u8(crc, *p++);
+            return crc;
+        }
+    #elif defined(SFIO_CRC32C_HARDWARE)
+    #if defined(__clang__)
+        __attribute__((target("crc")))
+    #else
+        __attribute__((target("+crc")))
+    #endif
+        inline uint32_t crc32cHardware(uint32_t crc, const unsigned char* p, size_t n) noexcept {
+            for (; n >= 8; n -= 8, p += 8)
+                crc = __crc32cd(crc, loadU64LE(reinterpret_cast<const char*>(p)));
+            for (; n > 0; --n) crc = __crc32cb(crc, *p++);
+            return crc;
+        }
+    #endif
+
+        /**
+         * @brief True if crc32cHardware may run on this CPU (checked once).
+         */
+        inline bool crc32cHardwareSupported() noexcept {
+        #if defined(__SSE4_2__) || defined(__ARM_FEATURE_CRC32)
+            return true; // the build already requires it
+        #elif defined(SFIO_CRC32C_HARDWARE) && defined(__x86_64__)
+            static const bool supported = [] {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("sse4.2") != 0;
+            }();
+            return supported;
+        #elif defined(SFIO_CRC32C_HARDWARE) && defined(__linux__)
+            constexpr unsigned long HwcapCrc32 = 1UL << 7; // HWCAP_CRC32 from <asm/hwcap.h>
+            static const bool supported = (::getauxval(AT_HWCAP) & HwcapCrc32) != 0;
+            return supported;
+        #else
+            return false;
+        #endif
+        }
+
+        /**
+         * @brief Continues a CRC32C over [data, data + n); @p crc is the raw
+         *        (pre-inverted) register.
+         */
+        inline uint32_t crc32cUpdate(uint32_t crc, const char* data, size_t n) noexcept {
+            auto p = reinterpret_cast<const unsigned char*>(data);
+        #if defined(SFIO_CRC32C_HARDWARE)
+            if (crc32cHardwareSupported()) return crc32cHardware(crc, p, n);
+        #endif
+            return crc32cSoftware(crc, p, n);
+        }
+
+        /**
+         * @brief Incremental CRC32C or xxHash64 over a byte stream.
+         */
+        class Checksummer {
+        public:
+            Checksummer() = default;
+            explicit Checksummer(Checksum checksum) noexcept : kind(checksum) {}
+
+            Checksum type() const noexcept { return kind; }
+
+            /**
+             * @brief Size of the digest in bytes (0 for Checksum::None).
+             */
+            size_t digestSize() const noexcept {
+                return kind == Checksum::Crc32c ? 4 : kind == Checksum::XxHash64 ? 8 : 0;
+            }
+
+            inline void update(const char* data, size_t n) noexcept;
+            inline uint64_t digest() const noexcept;
+
+        private:
+            static constexpr uint64_t P1 = 11400714785074694791ULL;
+            static constexpr uint64_t P2 = 14029467366897019727ULL;
+            static constexpr uint64_t P3 = 1609587929392839161ULL;
+            static constexpr uint64_t P4 = 9650029242287828579ULL;
+            static constexpr uint64_t P5 = 2870177450012600261ULL;
+
+            static uint64_t round(uint64_t acc, uint64_t input) noexcept {
+                return std::rotl(acc + input * P2, 31) * P1;
+            }
+
+            static uint64_t mergeRound(uint64_t acc, uint64_t value) noexcept {
+                return (acc ^ round(0, value)) * P1 + P4;
+            }
+
+            Checksum kind = Checksum::None;
+            uint32_t crc = 0xFFFFFFFFu;
+            uint64_t total = 0;
+            uint64_t lanes[4] = {P1 + P2, P2, 0, 0 - P1}; // xxHash64 with seed 0
+            char stripe[32];                              // pending partial stripe
+            size_t pending = 0;
+        };
+
+        inline void Checksummer::update(const char* data, size_t n) noexcept {
+            if (kind == Checksum::Crc32c) {
+                crc = crc32cUpdate(crc, data, n);
+                return;
+            }
+            if (kind != Checksum::XxHash64) return;
+
+            total += n;
+            if (pending + n < sizeof(stripe)) {
+                std::memcpy(stripe + pending, data, n);
+                pending += n;
+                return;
+            }
+            if (pending > 0) {
+                size_t take = sizeof(stripe) - pending;
+                std::memcpy(stripe + pending, data, take);
+                for (int i = 0; i < 4; ++i) lanes[i] = round(lanes[i], loadU64LE(stripe + 8 * i));
+                data += take;
+                n -= take;
+                pending = 0;
+            }
+            for (; n >= sizeof(stripe); data += sizeof(stripe), n -= sizeof(stripe))
+                for (int i = 0; i < 4; ++i) lanes[i] = round(lanes[i], loadU64LE(data + 8 * i));
+            std::memcpy(stripe, data, n);
+            pending = n;
+        }
+
+        inline uint64_t Checksummer::digest() const noexcept {
+            if (kind == Checksum::Crc32c) return ~crc;
+            if (kind != Checksum::XxHash64) return 0;
+
+            uint64_t h;
+            if (total >= sizeof(stripe)) {
+                h = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+                for (uint64_t lane : lanes) h = mergeRound(h, lane);
+            } else {
+                h = P5;
+            }
+            h += total;
+
+            const char* p = stripe;
+            size_t n = pending;
+            for (; n >= 8; p += 8, n -= 8)
+                h = std::rotl(h ^ round(0, loadU64LE(p)), 27) * P1 + P4;
+            if (n >= 4) {
+                h = std::rotl(h ^ (uint64_t(loadU32LE(p)) * P1), 23) * P2 + P3;
+                p += 4;
+                n -= 4;
+            }
+            for (; n > 0; ++p, --n)
+                h = std::rotl(h ^ (uint64_t(static_cast<unsigned char>(*p)) * P5), 11) * P1;
+
+            h ^= h >> 33;
+            h *= P2;
+            h ^= h >> 29;
+            h *= P3;
+            h ^= h >> 32;
+            return h;
+        }
+
+        /**
+         * @brief FileHandle with an optional compression layer on top.
+         *
+         * Readers and writers talk to a Stream; without a codec every call
+         * forwards straight to the handle. Compressed streams are sequential
+         * only: pread/pwrite fail with ESPIPE and native() returns -1, which
+         * keeps zero-copy paths away from the encoded bytes.
+         *
+         * An optional Checksummer sees every byte passing through read() and
+         * write() (after decoding, before encoding); positional calls are not
+         * included. With a trailer, writers append the digest on close and
+         * readers hold back the last digest-size bytes, verifying them at EOF.
+         */
+        class Stream {
+        public:
+            Stream() = default;
+            Stream(Stream&& other) noexcept = default;
+            Stream& operator=(Stream&& other) noexcept {
+                if (this != &other) {
+                    close();
+                    handle = std::move(other.handle);
+                    codec = std::move(other.codec);
+                    checksummer = other.checksummer;
+                    trailer = other.trailer;
+                    held = other.held;
+                    std::memcpy(tail, other.tail, sizeof(tail));
+                }
+                return *this;
+            }
+            ~Stream() { close(); }
+
+            static Stream open(const std::string& path, OpenMode mode, bool binary) {
+                Stream stream;
+                stream.handle = FileHandle::open(path, mode, binary);
+                return stream;
+            }
+
+            /**
+             * @brief Places a decoder (reading) or encoder (writing) over the file.
+             * @return False if the requested or detected format is not available
+             */
+            inline bool setCompression(Compression compression, bool encode, const std::string& path);
+
+            /**
+             * @brief Starts checksumming; @p withTrailer appends (writing) or
+             *        strips and verifies (reading) a little-endian digest.
+             */
+            void setChecksum(Checksum checksum, bool withTrailer) noexcept {
+                checksummer = Checksummer(checksum);
+                trailer = withTrailer && checksum != Checksum::None;
+            }
+
+            uint64_t checksum() const noexcept { return checksummer.digest(); }
+            bool hasTrailer() const noexcept { return trailer; }
+
+            /**
+             * @brief Continues on another file (follow-mode rotation).
+             *
+             * Only the handle changes: the checksum state carries over, so
+             * the digest covers the data of both files. Not for compressed
+             * streams or streams verifying a trailer.
+             */
+            void replaceHandle(FileHandle next) noexcept { handle = std::move(next); }
+
+            explicit operator bool() const noexcept { return static_cast<bool>(handle); }
+            bool compressed() const noexcept { return codec != nullptr; }
+
+            ptrdiff_t read(char* dst, size_t n) noexcept {
+                if (trailer) return readHoldingTrailer(dst, n);
+                ptrdiff_t got = readRaw(dst, n);
+                if (got > 0) checksummer.update(dst, static_cast<size_t>(got));
+                return got;
+            }
+
+            ptrdiff_t pread(char* dst, size_t n, uint64_t offset) noexcept {
+                if (codec) {
+                    errno = ESPIPE;
+                    return -1;
+                }
+                return handle.pread(dst, n, offset);
+            }
+
+            bool write(const char* src, size_t n) noexcept {
+                checksummer.update(src, n);
+                return writeRaw(src, n);
+            }
+
+            bool pwrite(const char* src, size_t n, uint64_t offset) noexcept {
+                if (codec) {
+                    errno = ESPIPE;
+                    return false;
+                }
+                return handle.pwrite(src, n, offset);
+            }
+
+            /**
+             * @brief Moves the sequential position; fails with ESPIPE when
+             *        compressed or verifying a trailer.
+             */
+            bool seek(uint64_t offset) noexcept {
+                if (codec || trailer) {
+                    errno = ESPIPE;
+                    return false;
+                }
+                return handle.seek(offset);
+            }
+
+            bool flush() noexcept {
+                return (!codec || codec->flush(handle)) && handle.flush();
+            }
+
+            /**
+             * @brief Appends the checksum trailer if one was requested (writers only).
+             */
+            bool writeTrailer() noexcept {
+                if (!trailer) return true;
+                trailer = false;
+                char digest[8];
+                storeDigest(digest);
+                return writeRaw(digest, checksummer.digestSize());
+            }
+
+            /**
+             * @return False if ending the compressed stream failed
+             */
+            bool close() noexcept {
+                bool ok = !codec || !handle || codec->finish(handle);
+                codec.reset();
+                handle.close();
+                return ok;
+            }
+
+            int native() const noexcept { return codec ? -1 : handle.native(); }
+
+        private:
+            ptrdiff_t readRaw(char* dst, size_t n) noexcept {
+                return codec ? codec->read(handle, dst, n) : handle.read(dst, n);
+            }
+
+            bool writeRaw(const char* src, size_t n) noexcept {
+                return codec ? codec->write(handle, src, n) : handle.write(src, n);
+            }
+
+            void storeDigest(char* out) const noexcept {
+                uint64_t digest = checksummer.digest();
+                for (size_t i = 0; i < checksummer.digestSize(); ++i) out[i] = static_cast<char>(digest >> (8 * i));
+            }
+
+            inline ptrdiff_t readHoldingTrailer(char* dst, size_t n) noexcept;
+
+            FileHandle handle;
+            std::unique_ptr<Codec> codec;
+            Checksummer checksummer;
+            bool trailer = false;
+            size_t held = 0;  // bytes in tail not yet returned
+            char tail[8];     // last bytes read: the trailer candidate
+        };
+
+        inline ptrdiff_t Stream::readHoldingTrailer(char* dst, size_t n) noexcept {
+            if (n == 0) return 0;
+            const size_t keep = checksummer.digestSize();
+            char small[16];
+
+            while (true) {
+                // Held bytes come first, then fresh data; the last `keep`
+                // bytes of the combined run are held back again
+                char* combined = n > keep ? dst : small;
+                std::memcpy(combined, tail, held);
+                ptrdiff_t got = readRaw(combined + held, n > keep ? n - held : n);
+                if (got < 0) return -1;
+                if (got == 0) {
+                    char expected[8];
+                    storeDigest(expected);
+                    if (held != keep || std::memcmp(tail, expected, keep) != 0) {
+                        errno = EIO; // truncated or mismatching trailer
+                        return -1;
+                    }
+                    return 0;
+                }
+
+                size_t total = held + static_cast<size_t>(got);
+                if (total > keep) {
+                    size_t out = total - keep;
+                    std::memcpy(tail, combined + out, keep);
+                    held = keep;
+                    if (combined != dst) std::memcpy(dst, combined, out);
+                    checksummer.update(dst, out);
+                    return static_cast<ptrdiff_t>(out);
+                }
+                std::memcpy(tail, combined, total);
+                held = total;
+            }
+        }
+
+        inline bool Stream::setCompression(Compression compression, bool encode, const std::string& path) {
+            if (compression == Compression::Auto)
+                compression = encode ? compressionForPath(path) : detectCompression(handle);
+            if (compression == Compression::None) return true;
+            codec = makeCodec(compression, encode);
+            return codec != nullptr;
+        }
+
+        /**
+         * @brief Runs fn(i) for every i in [0, count) on up to @p threads threads.
+         *
+         * Work is handed out through an atomic counter, so uneven items
+         * balance themselves; the calling thread takes part. The first
+         * exception thrown by fn stops further work and is rethrown here.
+         *
+         * @param threads Thread count; 0 uses all hardware threads
+         */
+        template<typename Fn>
+        inline void parallelFor(size_t count, unsigned threads, Fn&& fn) {
+            if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+            threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+            if (threads <= 1) {
+                for (size_t i = 0; i < count; ++i) fn(i);
+                return;
+            }
+
+            std::atomic<size_t> next{0};
+            std::exception_ptr error;
+            std::mutex errorLock;
+            auto worker = [&] {
+                try {
+                    for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count; )
+                        fn(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorLock);
+                    if (!error) error = std::current_exception();
+                    next.store(count, std::memory_order_relaxed);
+                }
+            };
+
+            std::vector<std::thread> pool;
+            pool.reserve(threads - 1);
+            for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+            worker();
+            for (auto& thread : pool) thread.join();
+            if (error) std::rethrow_exception(error);
+        }
+
+        /**
+         * @brief Threads usable for concurrent pread on one handle.
+         *
+         * The stdio backend emulates pread with seek + read, which is not
+         * thread-safe, so it always gets one.
+         */
+        inline unsigned preadThreads(unsigned threads) noexcept {
+        #if defined(SFIO_USE_STDIO)
+            (void)threads;
+            return 1;
+        #else
+            return threads;
+        #endif
+        }
+
+        /**
+         * @brief Wakes a follower when a file or its directory changes.
+         *
+         * On Linux one inotify instance watches the file (IN_MODIFY, and
+         * IN_MOVE_SELF / IN_DELETE_SELF / IN_ATTRIB for rotation) and its
+         * directory (IN_CREATE / IN_MOVED_TO, for the replacement file).
+         * Wakeups may be spurious; callers re-check the file afterwards.
+         * Elsewhere wait() sleeps for a short interval instead.
+         */
+        class FileWatcher {
+        public:
+            explicit FileWatcher(const std::string& path) {
+            #if defined(__linux__)
+                fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+                if (fd < 0) return;
+                auto parent = std::filesystem::path(path).parent_path();
+                ::inotify_add_watch(fd, parent.empty() ? "." : parent.c_str(), IN_CREATE | IN_MOVED_TO);
+                rewatch(path);
+            #else
+                (void)path;
+            #endif
+            }
+
+            ~FileWatcher() {
+            #if defined(__linux__)
+                if (fd >= 0) ::close(fd);
+            #endif
+            }
+
+            FileWatcher(const FileWatcher&) = delete;
+            FileWatcher& operator=(const FileWatcher&) = delete;
+
+            /**
+             * @brief Moves the file watch to whatever @p path names now.
+             */
+            void rewatch(const std::string& path) noexcept {
+            #if defined(__linux__)
+                if (fd < 0) return;
+                if (fileWatch >= 0) ::inotify_rm_watch(fd, fileWatch);
+                fileWatch = ::inotify_add_watch(fd, path.c_str(),
+                                                IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+            #else
+                (void)path;
+            #endif
+            }
+
+            /**
+             * @brief Blocks until something may have changed or @p timeoutMs
+             *        passed (-1 waits forever).
+             */
+            void wait(int timeoutMs) noexcept {
+            #if defined(__linux__)
+                if (fd >= 0) {
+                    pollfd pfd{fd, POLLIN, 0};
+                    int ready;
+                    while ((ready = ::poll(&pfd, 1, timeoutMs)) < 0 && errno == EINTR) {}
+                    alignas(inotify_event) char events[4096];
+                    if (ready > 0)
+                        while (::read(fd, events, sizeof(events)) > 0) {} // drain; the caller re-checks
+                    return;
+                }
+            #endif
+                int interval = timeoutMs < 0 ? 100 : std::min(timeoutMs, 100);
+                std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+            }
+
+        private:
+        #if defined(__linux__)
+            int fd = -1;
+            int fileWatch = -1;
+        #endif
+        };
+
+        /**
+         * @brief Finds @p sep in [data, data + n) using memchr for candidates.
+         */
+        inline const char* findSeparator(const char* data, size_t n, std::string_view sep) noexcept {
+            const char* end = data + n;
+            const char* p = data;
+            while (static_cast<size_t>(end - p) >= sep.size()) {
+                auto candidate = static_cast<const char*>(
+                    std::memchr(p, sep[0], static_cast<size_t>(end - p) - sep.size() + 1));
+                if (!candidate) return nullptr;
+                if (std::memcmp(candidate + 1, sep.data() + 1, sep.size() - 1) == 0) return candidate;
+                p = candidate + 1;
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Separators between numeric fields: whitespace and commas.
+         */
+        inline bool isFieldSeparator(char c) noexcept {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',';
+        }
+
+        /**
+         * @brief True if all eight bytes at @p p are ASCII digits (SWAR).
+         */
+        inline bool isEightDigits(const char* p) noexcept {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            return (((v & 0xF0F0F0F0F0F0F0F0ULL) |
+                     (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+                    0x3333333333333333ULL);
+        }
+
+        /**
+         * @brief Converts eight ASCII digits to their value with three multiplies.
+         */
+        inline uint32_t parseEightDigits(const char* p) noexcept {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            v = (v & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+            v = (v & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+            return static_cast<uint32_t>((v & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32);
+        }
+
+        /**
+         * @brief Parses a whole token as int64_t; false if malformed or out of range.
+         */
+        inline bool parseInt64(std::string_view token, int64_t& value) noexcept {
+            const char* p = token.data();
+            const char* end = p + token.size();
+            bool negative = false;
+            if (p != end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+            size_t digits = static_cast<size_t>(end - p);
+            if (digits == 0) return false;
+
+            if (digits > 18) { // may overflow: let from_chars range-check it
+                if (static_cast<unsigned>(static_cast<unsigned char>(*p) - '0') > 9) return false; // e.g. "+-1"
+                auto [last, ec] = std::from_chars(token.data() + (token[0] == '+'), end, value);
+                return ec == std::errc() && last == end;
+            }
+
+            uint64_t result = 0;
+            if constexpr (std::endian::native == std::endian::little) {
+                while (end - p >= 8 && isEightDigits(p)) {
+                    result = result * 100000000ULL + parseEightDigits(p);
+                    p += 8;
+                }
+            }
+            for (; p != end; ++p) {
+                unsigned d = static_cast<unsigned char>(*p) - '0';
+                if (d > 9) return false;
+                result = result * 10 + d;
+            }
+            value = negative ? -static_cast<int64_t>(result) : static_cast<int64_t>(result);
+            return true;
+        }
+    }
+
+    /**
+     * @ingroup TextIO
+     * @class LineIndex
+     * @brief Start offsets of every line in a file, for O(1) line access.
+     *
+     * build() scans the file once, in parallel chunks, with the same 64-byte
+     * SIMD delimiter masks as CsvReader. The index can be saved as a sidecar
+     * file: a 32-byte header (magic "SFIOLIX1", file size, line count,
+     * delimiter) followed by each line length as a LEB128 varint, so typical
+     * log lines cost one or two bytes each.
+     *
+     * Lines follow readLine(): a final delimiter does not start an empty line.
+     * The index describes the file as it was when built; fileSize() can be
+     * compared against the file to detect staleness.
+     */
+    class LineIndex {
+    public:
+        LineIndex() = default;
+
+        /**
+         * @brief Indexes @p path.
+         *
+         * @param path      File to index
+         * @param delimiter Line delimiter
+         * @param threads   Thread count; 0 uses all hardware threads
+         *
+         * @throws IOException if the file cannot be opened or read
+         */
+        inline static LineIndex build(const std::string& path, char delimiter = '\n', unsigned threads = 0);
+
+        /**
+         * @brief Loads an index written by save().
+         *
+         * @throws IOException if the file cannot be read or is not a line index
+         */
+        inline static LineIndex load(const std::string& indexPath);
+
+        /**
+         * @brief Writes the index as a compact sidecar file.
+         *
+         * @throws IOException on write failure
+         */
+        inline void save(const std::string& indexPath) const;
+
+        /**
+         * @brief Number of lines.
+         */
+        size_t lineCount() const noexcept { return offsets.size() - 1; }
+
+        /**
+         * @brief Byte offset where line @p n starts; lineStart(lineCount()) is fileSize().
+         */
+        uint64_t lineStart(size_t n) const noexcept { return offsets[n]; }
+
+        /**
+         * @brief Size of the indexed file.
+         */
+        uint64_t fileSize() const noexcept { return offsets.back(); }
+
+        char delimiter() const noexcept { return separator; }
+
+    private:
+        std::vector<uint64_t> offsets{0}; // line starts, plus the file size
+        char separator = '\n';
+    };
+
+    /**
+     * @ingroup TextIO
+     * @class BasicTextReader
+     * @brief High-performance buffered text file reader.
+     *
+     * Optimized for sequential access using a pooled buffer (1 MB by
+     * default, shrunk to the file size for small files).
+     *
+     * @note Lines end at '\n' by default; see setDelimiter() for other
+     *       separators and setStripCR() for CRLF input. No other newline
+     *       conversion is performed.
+     *
+     * @tparam Allocator Allocator for the pooled buffer (see BasicBufferPool)
+     */
+    template<typename Allocator = std::allocator<char>>
+    class BasicTextReader {
+    public:
+        /**
+         * @brief Opens a text file for reading.
+         * @param path        Path to the file
+         * @param bufferSize  Upper bound for the read buffer size
+         * @param compression Decompression layer (Compression::Auto detects it)
+         * @param checksum    Digest computed over the data as it is read (see checksum())
+         * @param trailer     The file ends with a checksum trailer (see
+         *                    BasicTextWriter): it is not returned as data and
+         *                    reaching EOF with a mismatching digest is a read error
+         * @throws IOException if the file cannot be opened or the format is
+         *         not available in this build
+         */
+        inline BasicTextReader(const std::string& path, size_t bufferSize = DefaultBufferSize,
+                               Compression compression = Compression::None,
+                               Checksum checksum = Checksum::None, bool trailer = false);
+        
+        /**
+         * @brief Closes the file and releases resources.
+         */
+        inline ~BasicTextReader();
+
+        /**
+         * @brief Checks whether a file exists.
+         * @param path Path to the file
+         * @return True if the file exists
+         */
+        inline static bool exists(const std::string& path);
+
+        /**
+         * @brief Fraction (0 to 1) of the file's pages in the page cache.
+         *
+         * Asks cachestat(2) on Linux 6.5+ and falls back to mincore(2) over
+         * an untouched mapping; no file data is read. An empty file counts
+         * as fully cached. Without either call the file is reported cold (0).
+         *
+         * @throws IOException if the file cannot be opened
+         */
+        inline static double cachedFraction(const std::string& path) { return detail::cachedFraction(path); }
+
+        /**
+         * @brief Starts loading a byte range into the page cache.
+         *
+         * Returns once the reads are queued (readahead(2), or
+         * POSIX_FADV_WILLNEED), so later reads of the range hit memory.
+         *
+         * @throws IOException if the file cannot be opened
+         */
+        inline static void prefetch(const std::string& path, uint64_t offset = 0,
+                                    uint64_t length = std::numeric_limits<uint64_t>::max()) {
+            detail::prefetch(path, offset, length);
+        }
+
+        /**
+         * @brief Reads the entire file into a string.
+         *
+         * @return String containing all file contents
+         *
+         * @throws IOException on read failure
+         *
+         * @complexity Time: O(n)  
+         * @complexity Space: O(n)
+         */
+        inline std::string readString();
+        
+        /**
+         * @brief Reads a single line from the file.
+         *
+         * The returned string does not include the trailing newline.
+         *
+         * @return The next line, or an empty string on EOF
+         *
+         * @throws IOException on read failure
+         *
+         * @complexity Amortized O(k), where k is line length
+         */
+        inline std::string readLine();
+
+        /**
+         * @brief Reads the next line into a caller-provided string.
+         *
+         * @p out is overwritten but keeps its capacity, so looping over a file
+         * with the same string performs no per-line allocation. Unlike
+         * readLine(), an empty line and EOF are distinguishable.
+         *
+         * @param out Receives the line without the trailing newline
+         * @return True if a line was read, false at EOF (@p out is then empty)
+         *
+         * @throws IOException on read failure
+         *
+         * @complexity Amortized O(k), where k is line length
+         */
+        inline bool readLine(std::string& out);
+
+        /**
+         * @brief Reads multiple lines from the file.
+         *
+         * @param numLines Maximum number of lines to read.
+         *                 If zero, reads until EOF.
+         * @return Vector containing the read lines
+         *
+         * @throws IOException on read failure
+         *
+         * @complexity Time: O(n)  
+         * @complexity Space: O(n)
+         */
+        inline std::vector<std::string> readLines(int numLines = 0);
+
+        /**
+         * @brief Non-throwing variant of readLine().
+         *
+         * @return The next line (without the newline), or IOError::EndOfFile
+         *         once no more lines remain. An empty line is a value, never EOF.
+         *
+         * @complexity Amortized O(k), where k is line length
+         */
+        inline std::expected<std::string, IOError> tryReadLine();
+
+        /**
+         * @brief Digest of the data read from the file so far.
+         *
+         * Read-ahead in the buffer is included, so the value covers the whole
+         * file once a read has reached EOF. Returns 0 with Checksum::None.
+         */
+        uint64_t checksum() const noexcept { return file.checksum(); }
+
+        /**
+         * @brief Sets the byte that terminates a line (default '\n').
+         */
+        inline void setDelimiter(char delimiter);
+
+        /**
+         * @brief Sets a (possibly multi-byte) line separator, e.g. "\r\n" or "||".
+         *
+         * @param separator Non-empty separator, at most MinBufferSize / 2 bytes
+         * @throws std::invalid_argument if the separator is empty or too long
+         */
+        inline void setDelimiter(std::string_view separator);
+
+        /**
+         * @brief Strips a '\r' directly preceding each delimiter.
+         *
+         * With the default delimiter this reads CRLF and LF files alike.
+         * The check happens once per line inside the scan, so it is free
+         * compared to post-processing each line.
+         */
+        inline void setStripCR(bool enabled);
+
+        /**
+         * @brief Keeps reading lines as the file grows, like `tail -F`.
+         *
+         * At EOF readLine(), readLines() and tryReadLine() block until more
+         * data arrives instead of reporting EOF; on Linux the wait is an
+         * inotify event, not polling. An unterminated last line is held
+         * back until its delimiter is written. If the path is renamed or
+         * deleted and recreated (inode change), or the file is truncated,
+         * the reader finishes the old file and continues at the start of the
+         * new one; an unterminated last line of the old file is returned as is.
+         * The reader keeps its settings across the switch, and checksum()
+         * goes on covering every byte read from the old and the new file.
+         *
+         * @param enabled   Turns follow mode on or off
+         * @param timeoutMs Longest wait for new data per call (-1 waits forever);
+         *                  on timeout the call reports EOF and any partial
+         *                  line is kept for the next call
+         *
+         * @throws std::invalid_argument for compressed readers and readers
+         *         verifying a checksum trailer
+         *
+         * @note Numeric parsing and readString() still stop at the current EOF.
+         */
+        inline void setFollow(bool enabled, int timeoutMs = -1);
+
+        /**
+         * @brief Moves the read position to byte @p offset of the file.
+         *
+         * If the target is still in the read buffer only the cursor moves;
+         * otherwise the buffer is dropped and the file is repositioned.
+         *
+         * @throws IOException if the file cannot seek (compressed readers,
+         *         checksum trailers) and the target is not buffered
+         *
+         * @complexity O(1)
+         */
+        inline void seek(uint64_t offset);
+
+        /**
+         * @brief Byte offset of the next unread byte.
+         */
+        inline uint64_t tell() const noexcept;
+
+        /**
+         * @brief Advances the read position by @p bytes.
+         *
+         * Compressed readers decode and discard the skipped data.
+         *
+         * @throws IOException on read or seek failure
+         */
+        inline void skip(uint64_t bytes);
+
+        /**
+         * @brief Reads up to dst.size() bytes at @p offset with pread.
+         *
+         * Leaves the buffer and the read position alone, so concurrent calls
+         * on one reader are safe (except with SFIO_USE_STDIO, which emulates
+         * pread).
+         *
+         * @return Bytes read; short only at EOF
+         *
+         * @throws IOException on read failure or for compressed readers
+         */
+        inline size_t readAt(uint64_t offset, std::span<char> dst);
+
+        /**
+         * @brief Positions the reader so the next readLine() returns line @p n.
+         *
+         * Reuses the buffered data when the line starts inside it, otherwise
+         * seeks the file.
+         *
+         * @param index Index built for this file
+         * @param n     Zero-based line number; lineCount() positions at EOF
+         *
+         * @throws std::invalid_argument if the index was built for another delimiter
+         * @throws std::out_of_range if n > index.lineCount()
+         * @throws IOException if the file cannot seek (e.g. compressed readers)
+         *
+         * @complexity O(1)
+         */
+        inline void seekLine(const LineIndex& index, size_t n);
+
+        /**
+         * @brief Reads lines [first, last) with one positional read.
+         *
+         * Line boundaries come from the index, so nothing is scanned; a
+         * trailing '\r' is dropped when setStripCR() is on. The sequential
+         * position is not changed.
+         *
+         * @throws std::invalid_argument if the index was built for another delimiter
+         * @throws std::out_of_range if first > last or last > index.lineCount()
+         * @throws IOException on read failure (e.g. compressed readers)
+         *
+         * @complexity O(bytes in the range)
+         */
+        inline std::vector<std::string> readLineRange(const LineIndex& index, size_t first, size_t last);
+
+        /**
+         * @brief Parses the next integer directly from the read buffer.
+         *
+         * Leading whitespace and one comma are skipped. Up to 18 digits are
+         * converted eight at a time with a SWAR fast path; longer values
+         * fall back to std::from_chars (which reports overflow).
+         *
+         * @param value Receives the parsed value
+         * @return True if a value was read, false at EOF
+         *
+         * @throws IOException if the next token is not a valid integer
+         */
+        inline bool readInt64(int64_t& value);
+
+        /**
+         * @brief Parses the next floating-point value directly from the read buffer.
+         *
+         * Leading whitespace and one comma are skipped; conversion uses
+         * std::from_chars, so no temporary string is allocated.
+         *
+         * @param value Receives the parsed value
+         * @return True if a value was read, false at EOF
+         *
+         * @throws IOException if the next token is not a valid number
+         */
+        inline bool readDouble(double& value);
+
+        /**
+         * @brief Parses one line into the given columns.
+         *
+         * Columns are separated by runs of spaces and tabs, or by a single
+         * comma (optionally surrounded by them); blank lines are skipped and
+         * anything after the last requested column is ignored. An empty
+         * comma-delimited field, as in `1,,3`, is a missing column.
+         * Supported column types are integers, floating-point types and
+         * std::string.
+         *
+         * Example: `int64_t id; double x, y; while (reader.parseColumns(id, x, y)) ...`
+         *
+         * @return True if a row was parsed, false at EOF
+         *
+         * @throws IOException if a column is missing or malformed
+         */
+        template<typename... Columns>
+        inline bool parseColumns(Columns&... columns);
+
+    private:
+        inline std::expected<size_t, IOError> fill();
+        inline bool skipFieldSeparators(bool acrossLines, bool comma = true);
+        inline void checkIndex(const LineIndex& index) const;
+        inline std::string_view nextToken();
+        template<typename T>
+        inline void parseToken(std::string_view token, T& value);
+        [[noreturn]] inline void throwMalformed(std::string_view token);
+        inline std::expected<void, IOError> nextLine(std::string& out);
+        inline std::expected<void, IOError> nextLineMultiByte(std::string& out);
+        inline void appendLine(std::string& out, const char* start, size_t length);
+
+        enum class FollowEvent { Data, Rotated, Timeout };
+        inline FollowEvent awaitData();
+
+        template<typename> friend class BasicCsvReader;
+
+        detail::Stream file;
+        std::string path;
+
+        typename BasicBufferPool<Allocator>::Buffer buffer; // pooled read buffer
+        size_t cursor = 0;        // current position in buffer
+        size_t bufferEnd = 0;     // end of valid data in buffer
+
+        std::string separator = "\n"; // line separator
+        bool stripCR = false;     // drop '\r' before each separator
+
+        uint64_t consumed = 0;    // bytes read from the current file
+        bool follow = false;      // wait for more data at EOF
+        int followTimeout = -1;   // per-call wait limit in ms (-1: none)
+        std::unique_ptr<detail::FileWatcher> watcher;
+        std::string partial;      // unterminated line held over from a timeout
+    };
+
+    /**
+     * @ingroup TextIO
+     * @brief TextReader using the standard allocator.
+     */
+    using TextReader = BasicTextReader<>;
+
+    template<typename Allocator>
+    inline BasicTextReader<Allocator>::BasicTextReader(const std::string& p, size_t bufferSize, Compression compression,
+                                                      Checksum checksum, bool trailer)
+        : path(p)
+    {
+        // Open the file in text read mode
+        file = detail::Stream::open(path, detail::OpenMode::Read, false);
+        if (!file) {
+            IOError code = detail::openError(errno);
+            throw IOException(code, formatIOError(code, path), path);
+        }
+        if (!file.setCompression(compression, false, path))
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path, "Compression format not available in this build."), path);
+        file.setChecksum(checksum, trailer);
+
+        // Pooled, uninitialized buffer; small files get a small buffer
+        // (decompressed data outgrows the file, so keep the full size then)
+        buffer = BasicBufferPool<Allocator>::local().acquire(
+            file.compressed() ? bufferSize : detail::readBufferSize(path, bufferSize));
+    }
+
+    template<typename Allocator>
+    inline BasicTextReader<Allocator>::~BasicTextReader() {
+        // FileHandle closes the file
+    }
+
+    template<typename Allocator>
+    inline bool BasicTextReader<Allocator>::exists(const std::string& path) {
+        return std::filesystem::exists(path);
+    }
+
+    template<typename Allocator>
+    inline std::string BasicTextReader<Allocator>::readString() {
+        if (!file) 
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        // Start with whatever is still buffered, then read straight into the
+        // result (no bounce through our buffer); +1 leaves room for the EOF probe
+        std::string result;
+        result.reserve(detail::fileSizeHint(path, 4 << 20) + 1); // exact size when known
+        result.append(buffer.data() + cursor, bufferEnd - cursor);
+        cursor = bufferEnd = 0;
+
+        while (true) {
+            size_t used = result.size();
+            size_t room = result.capacity() - used;
+            result.resize(used + (room > 0 ? room : buffer.size()));
+            ptrdiff_t bytesRead = file.read(result.data() + used, result.size() - used);
+            if (bytesRead < 0)
+                throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+            result.resize(used + static_cast<size_t>(bytesRead));
+            consumed += static_cast<uint64_t>(bytesRead);
+            if (bytesRead == 0) break;
+        }
+        return result;
+    }
+
+    template<typename Allocator>
+    inline std::expected<size_t, IOError> BasicTextReader<Allocator>::fill() {
+        // Keep unread bytes (e.g. a partial multi-byte separator) at the front
+        size_t leftover = bufferEnd - cursor;
+        if (leftover > 0 && cursor > 0)
+            std::memmove(buffer.data(), buffer.data() + cursor, leftover);
+        cursor = 0;
+        bufferEnd = leftover;
+
+        ptrdiff_t bytesRead = file.read(buffer.data() + leftover, buffer.size() - leftover);
+        if (bytesRead < 0) return std::unexpected(IOError::ReadError);
+        bufferEnd += static_cast<size_t>(bytesRead);
+        consumed += static_cast<uint64_t>(bytesRead);
+        return static_cast<size_t>(bytesRead);
+    }
+
+    template<typename Allocator>
+    inline typename BasicTextReader<Allocator>::FollowEvent BasicTextReader<Allocator>::awaitData() {
+        using Clock = std::chrono::steady_clock;
+        const auto deadline = Clock::now() + std::chrono::milliseconds(std::max(followTimeout, 0));
+
+        while (true) {
+            // Unread bytes in the open file come first, even if it was rotated
+            uint64_t size = 0;
+            bool replaced = false;
+        #if defined(__unix__) || defined(__APPLE__)
+            struct stat opened, named;
+            if (file.native() >= 0 && ::fstat(file.native(), &opened) == 0) {
+                size = static_cast<uint64_t>(opened.st_size);
+                replaced = ::stat(path.c_str(), &named) == 0
+                    && (named.st_ino != opened.st_ino || named.st_dev != opened.st_dev);
+            } else
+        #endif
+            {
+                size = detail::fileSizeHint(path, 0);
+            }
+            if (size > consumed) return FollowEvent::Data;
+
+            if (replaced || size < consumed) {
+                auto reopened = detail::FileHandle::open(path, detail::OpenMode::Read, false);
+                if (reopened) {
+                    file.replaceHandle(std::move(reopened));
+                    consumed = 0;
+                    watcher->rewatch(path);
+                    return FollowEvent::Rotated;
+                }
+            }
+
+            int remaining = -1;
+            if (followTimeout >= 0) {
+                auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now()).count();
+                if (left <= 0) return FollowEvent::Timeout;
+                remaining = static_cast<int>(left);
+            }
+            watcher->wait(remaining);
+        }
+    }
+
+    template<typename Allocator>
+    inline void BasicTextReader<Allocator>::appendLine(std::string& out, const char* start, size_t length) {
+        if (stripCR) {
+            if (length > 0) {
+                if (start[length - 1] == '\r') --length;
+            } else if (!out.empty() && out.back() == '\r') {
+                out.pop_back(); // '\r' was the last byte of the previous buffer
+            }
+        }
+        out.append(start, length);
+    }
+
+    template<typename Allocator>
+    inline std::expected<void, IOError> BasicTextReader<Allocator>::nextLine(std::string& out) {
+        if (!file) return std::unexpected(IOError::FileNotOpen);
+        if (separator.size() > 1) return nextLineMultiByte(out);
+
+        out.clear();
+        if (!partial.empty()) out.swap(partial); // line held over from a follow timeout
+        bool anyDataRead = !out.empty();
+        const char delimiter = separator[0];
+
+        while (true) {
+            if (cursor >= bufferEnd) {
+                auto bytesRead = fill();
+                if (!bytesRead) return std::unexpected(bytesRead.error());
+                if (*bytesRead == 0) {
+                    if (!follow) break; // normal EOF
+                    FollowEvent event = awaitData();
+                    if (event == FollowEvent::Timeout) {
+                        partial.swap(out);
+                        out.clear();
+                        return std::unexpected(IOError::EndOfFile);
+                    }
+                    if (event == FollowEvent::Rotated && anyDataRead) break; // old file's last line
+                    continue;
+                }
+            }
+
+            // memchr is vectorized by the C library
+            const char* start = buffer.data() + cursor;
+            size_t available = bufferEnd - cursor;
+            auto found = static_cast<const char*>(std::memchr(start, delimiter, available));
+            if (found) {
+                appendLine(out, start, static_cast<size_t>(found - start));
+                cursor += static_cast<size_t>(found - start) + 1; // skip delimiter
+                return {};
+            }
+
+            // Line continues past the buffered data
+            out.append(start, available);
+            cursor = bufferEnd;
+            anyDataRead = true;
+        }
+
+        if (!anyDataRead) return std::unexpected(IOError::EndOfFile);
+        return {};
+    }
+
+    template<typename Allocator>
+    inline std::expected<void, IOError> BasicTextReader<Allocator>::nextLineMultiByte(std::string& out) {
+        out.clear();
+        if (!partial.empty()) out.swap(partial); // line held over from a follow timeout
+        bool anyDataRead = !out.empty();
+        const size_t sepLength = separator.size();
+
+        while (true) {
+            const char* start = buffer.data() + cursor;
+            size_t available = bufferEnd - cursor;
+
+            if (available >= sepLength) {
+                const char* found = detail::findSeparator(start, available, separator);
+                if (found) {
+                    appendLine(out, start, static_cast<size_t>(found - start));
+                    cursor += static_cast<size_t>(found - start) + sepLength;
+                    return {};
+                }
+
+                // The tail may hold the start of a separator: keep it for the next fill
+                size_t taken = available - (sepLength - 1);
+                out.append(start, taken);
+                cursor += taken;
+                anyDataRead = true;
+            }
+
+            auto bytesRead = fill();
+            if (!bytesRead) return std::unexpected(bytesRead.error());
+            if (*bytesRead == 0) {
+                if (follow) {
+                    FollowEvent event = awaitData();
+                    if (event == FollowEvent::Data) continue;
+                    if (event == FollowEvent::Timeout) {
+                        partial.swap(out);
+                        out.clear();
+                        return std::unexpected(IOError::EndOfFile);
+                    }
+                }
+
+                // EOF or rotation: whatever is left is the last line
+                if (bufferEnd > cursor) {
+                    out.append(buffer.data() + cursor, bufferEnd - cursor);
+                    anyDataRead = true;
+                }
+                cursor = bufferEnd;
+                if (follow && !anyDataRead) continue;
+                break;
+            }
+        }
+
+        if (!anyDataRead) return std::unexpected(IOError::EndOfFile);
+        return {};
+    }
+
+    template<typename Allocator>
+    inline std::string BasicTextReader<Allocator>::readLine() {
+        std::string line;
+        auto status = nextLine(line);
+        if (!status && status.error() != IOError::EndOfFile)
+            throw IOException(status.error(), formatIOError(status.error(), path), path);
+        return line; // empty string on EOF, without throwing
+    }
+
+    template<typename Allocator>
+    inline bool BasicTextReader<Allocator>::readLine(std::string& out) {
+        auto status = nextLine(out);
+        if (status) return true;
+        if (status.error() == IOError::EndOfFile) return false;
+        throw IOException(status.error(), formatIOError(status.error(), path), path);
+    }
+
+    template<typename Allocator>
+    inline std::expected<std::string, IOError> BasicTextReader<Allocator>::tryReadLine() {
+        std::string line;
+        auto status = nextLine(line);
+        if (!status) return std::unexpected(status.error());
+        return line;
+    }
+
+    template<typename Allocator>
+    inline void BasicTextReader<Allocator>::setDelimiter(char delimiter) {
+        separator.assign(1, delimiter);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextReader<Allocator>::setDelimiter(std::string_view sep) {
+        if (sep.empty() || sep.size() > MinBufferSize / 2)
+            throw std::invalid_argument("TextReader delimiter must be 1 to " + std::to_string(MinBufferSize / 2) + " bytes");
+        separator.assign(sep);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextReader<Allocator>::setFollow(bool enabled, int timeoutMs) {
+        if (enabled && (file.compressed() || file.hasTrailer()))
+            throw std::invalid_argument("Follow mode is not available for compressed readers or checksum trailers.");
+        follow = enabled;
+        followTimeout = timeoutMs < 0 ? -1 : timeoutMs;
+        if (follow && !watcher) watcher = std::make_unique<detail::FileWatcher>(path);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextReader<Allocator>::seek(uint64_t offset) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        partial.clear();
+
+        // The buffer holds the file bytes [consumed - bufferEnd, consumed)
+        uint64_t bufferStart = consumed - bufferEnd;
+        if (offset >= bufferStart && offset <= consumed) {
+            cursor = static_cast<size_t>(offset - bufferStart);
+            return;
+        }
+        if (!file.seek(offset))
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path, "Failed to seek."), path);
+        cursor = bufferEnd = 0;
+        consumed = offset;
+    }
+
+    template<typename Allocator>
+    inline uint64_t BasicTextReader<Allocator>::tell() const noexcept {
+        // A line held over from a follow timeout has not been returned yet
+        return consumed - (bufferEnd - cursor) - partial.size();
+    }
+
+    template<typename Allocator>
+    inline void BasicTextReader<Allocator>::skip(uint64_t bytes) {
+        if (!file.compressed()) {
+            seek(tell() + bytes);
+            return;
+        }
+
+        partial.clear();
+        while (bytes > 0) {
+            if (cursor == bufferEnd) {
+                auto bytesRead = fill();
+                if (!bytesRead)
+                    throw IOException(bytesRead.error(), formatIOError(bytesRead.error(), path), path);
+                if (*bytesRead == 0) return; // skipping past EOF stops at EOF
+            }
+            size_t take = static_cast<size_t>(std::min<uint64_t>(bytes, bufferEnd - cursor));
+            cursor += take;
+            bytes -= take;
+        }
+    }
+
+    template<typename Allocator>
+    inline size_t BasicTextReader<Allocator>::readAt(uint64_t offset, std::span<char> dst) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        ptrdiff_t got = detail::preadFull(file, dst.data(), dst.size(), offset);
+        if (got < 0)
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+        return static_cast<size_t>(got);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextReader<Allocator>::checkIndex(const LineIndex& index) const {
+        // Offsets from another delimiter would silently split lines elsewhere
+        if (separator.size() != 1 || separator[0] != index.delimiter())
+            throw std::invalid_argument("LineIndex delimiter does not match the reader's line separator");
+    }
+
+    template<typename Allocator>
+    inline void BasicTextReader<Allocator>::seekLine(const LineIndex& index, size_t n) {
+        checkIndex(index);
+        if (n > index.lineCount())
+            throw std::out_of_range("Line " + std::to_string(n) + " is past the end of the index.");
+        seek(index.lineStart(n));
+    }
+
+    template<typename Allocator>
+    inline std::vector<std::string> BasicTextReader<Allocator>::readLineRange(const LineIndex& index, size_t first, size_t last) {
+        checkIndex(index);
+        if (first > last || last > index.lineCount())
+            throw std::out_of_range("Line range is past the end of the index.");
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        uint64_t begin = index.lineStart(first);
+        std::string bytes(static_cast<size_t>(index.lineStart(last) - begin), '\0');
+        if (detail::preadFull(file, bytes.data(), bytes.size(), begin) != static_cast<ptrdiff_t>(bytes.size()))
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+
+        std::vector<std::string> lines;
+        lines.reserve(last - first);
+        const char* data = bytes.data();
+        for (size_t n = first; n < last; ++n) {
+            size_t length = static_cast<size_t>(index.lineStart(n + 1) - index.lineStart(n));
+            const char* start = data;
+            data += length;
+            if (length > 0 && start[length - 1] == separator[0]) --length;
+            if (stripCR && length > 0 && start[length - 1] == '\r') --length;
+            lines.emplace_back(start, length);
+        }
+        return lines;
+    }
+
+    template<typename Allocator>
+    inline void BasicTextReader<Allocator>::setStripCR(bool enabled) {
+        stripCR = enabled;
+    }
+
+    template<typename Allocator>
+    inline bool BasicTextReader<Allocator>::skipFieldSeparators(bool acrossLines, bool comma) {
+        // Whitespace collapses, but a comma separates exactly once: a second
+        // one is left in place and ends the next token before it starts
+        bool commaSeen = !comma;
+        while (true) {
+            if (cursor >= bufferEnd) {
+                auto bytesRead = fill();
+                if (!bytesRead)
+                    throw IOException(bytesRead.error(), formatIOError(bytesRead.error(), path), path);
+                if (*bytesRead == 0) return false;
+            }
+            char c = buffer[cursor];
+            if (c == '\n' && !acrossLines) return true;
+            if (c == ',') {
+                if (commaSeen) return true;
+                commaSeen = true;
+            } else if (!detail::isFieldSeparator(c)) {
+                return true;
+            }
+            ++cursor;
+        }
+    }
+
+    template<typename Allocator>
+    inline std::string_view BasicTextReader<Allocator>::nextToken() {
+        size_t scanned = 0;
+        while (true) {
+            const char* start = buffer.data() + cursor;
+            size_t available = bufferEnd - cursor;
+            for (size_t i = scanned; i < available; ++i)
+                if (detail::isFieldSeparator(start[i])) return {start, i};
+
+            // Token runs to the end of the buffer: pull it to the front and refill
+            scanned = available;
+            if (available == buffer.size()) throwMalformed({start, std::min<size_t>(available, 32)});
+            auto bytesRead = fill();
+            if (!bytesRead)
+                throw IOException(bytesRead.error(), formatIOError(bytesRead.error(), path), path);
+            if (*bytesRead == 0) return {buffer.data() + cursor, bufferEnd - cursor}; // EOF ends the token
+        }
+    }
+
+    template<typename Allocator>
+    inline void BasicTextReader<Allocator>::throwMalformed(std::string_view token) {
+        throw IOException(IOError::ReadError,
+                          formatIOError(IOError::ReadError, path, "Malformed value '" + std::string(token) + "'"),
+                          path);
+    }
+
+    template<typename Allocator>
+    template<typename T>
+    inline void BasicTextReader<Allocator>::parseToken(std::string_view token, T& value) {
+        if (token.empty()) throwMalformed("<empty field>"); // between two commas
+        if constexpr (std::is_same_v<T, std::string>) {
+            value.assign(token);
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            if (!detail::parseInt64(token, value)) throwMalformed(token);
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            const char* first = token.data();
+            const char* last = first + token.size();
+            if (first != last && *first == '+') ++first; // from_chars rejects '+'
+            auto [end, ec] = std::from_chars(first, last, value);
+            if (ec != std::errc() || end != last) throwMalformed(token);
+        } else {
+            static_assert(std::is_arithmetic_v<T>, "parseColumns supports arithmetic types and std::string");
+        }
+    }
+
+    template<typename Allocator>
+    inline bool BasicTextReader<Allocator>::readInt64(int64_t& value) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        if (!skipFieldSeparators(true)) return false;
+        std::string_view token = nextToken();
+        parseToken(token, value);
+        cursor += token.size();
+        return true;
+    }
+
+    template<typename Allocator>
+    inline bool BasicTextReader<Allocator>::readDouble(double& value) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        if (!skipFieldSeparators(true)) return false;
+        std::string_view token = nextToken();
+        parseToken(token, value);
+        cursor += token.size();
+        return true;
+    }
+
+    template<typename Allocator>
+    template<typename... Columns>
+    inline bool BasicTextReader<Allocator>::parseColumns(Columns&... columns) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        if (!skipFieldSeparators(true, false)) return false; // also skips blank lines
+
+        bool first = true;
+        auto parseOne = [&](auto& column) {
+            if (!first && (!skipFieldSeparators(false) || buffer[cursor] == '\n'))
+                throwMalformed("<missing column>");
+            first = false;
+            std::string_view token = nextToken();
+            parseToken(token, column);
+            cursor += token.size();
+        };
+        (parseOne(columns), ...);
+
+        // Discard the rest of the line, including its newline, without copying it
+        while (true) {
+            auto newline = static_cast<const char*>(
+                std::memchr(buffer.data() + cursor, '\n', bufferEnd - cursor));
+            if (newline) {
+                cursor = static_cast<size_t>(newline - buffer.data()) + 1;
+                return true;
+            }
+            cursor = bufferEnd;
+            auto bytesRead = fill();
+            if (!bytesRead)
+                throw IOException(bytesRead.error(), formatIOError(bytesRead.error(), path), path);
+            if (*bytesRead == 0) return true;
+        }
+    }
+
+    template<typename Allocator>
+    inline std::vector<std::string> BasicTextReader<Allocator>::readLines(int numLines) {
+        std::vector<std::string> lines;
+        if (numLines > 0) lines.reserve(numLines);
+
+        // One scratch string whose capacity is reused; each stored line is an
+        // exact-size copy. EOF is signalled by readLine(), not by an empty line.
+        std::string line;
+        while (numLines == 0 || lines.size() < static_cast<size_t>(numLines)) {
+            if (!readLine(line)) break; // stop at EOF
+            lines.push_back(line);
+        }
+
+        return lines;
+    }
+
+    namespace detail {
+        /**
+         * @brief Bitmask of the bytes equal to @p c in a 64-byte block.
+         */
+        inline uint64_t matchMask64(const char* block, char c) noexcept {
+        #if defined(__AVX2__)
+            const __m256i needle = _mm256_set1_epi8(c);
+            auto lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), needle)));
+            auto hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32)), needle)));
+            return uint64_t(lo) | (uint64_t(hi) << 32);
+        #elif defined(__SSE2__)
+            const __m128i needle = _mm_set1_epi8(c);
+            uint64_t mask = 0;
+            for (int i = 0; i < 4; ++i) {
+                auto bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i)), needle)));
+                mask |= uint64_t(bits) << (16 * i);
+            }
+            return mask;
+        #else
+            uint64_t mask = 0;
+            for (int i = 0; i < 64; ++i)
+                mask |= uint64_t(block[i] == c) << i;
+            return mask;
+        #endif
+        }
+
+        /**
+         * @brief Number of bytes equal to @p c in [data, data + n) (SIMD masks + popcount).
+         */
+        inline uint64_t countByte(const char* data, size_t n, char c) noexcept {
+            uint64_t count = 0;
+            size_t i = 0;
+            for (; i + 64 <= n; i += 64) count += static_cast<uint64_t>(std::popcount(matchMask64(data + i, c)));
+            for (; i < n; ++i) count += data[i] == c;
+            return count;
+        }
+
+        /**
+         * @brief Prefix XOR: bit i is the parity of bits 0..i of @p x.
+         *
+         * Turns a quote mask into an "inside quotes" mask.
+         */
+        inline uint64_t prefixXor(uint64_t x) noexcept {
+        #if defined(__PCLMUL__)
+            __m128i product = _mm_clmulepi64_si128(
+                _mm_set_epi64x(0, static_cast<long long>(x)), _mm_set1_epi8(-1), 0);
+            return static_cast<uint64_t>(_mm_cvtsi128_si64(product));
+        #else
+            x ^= x << 1;
+            x ^= x << 2;
+            x ^= x << 4;
+            x ^= x << 8;
+            x ^= x << 16;
+            x ^= x << 32;
+            return x;
+        #endif
+        }
+    }
+
+    /**
+     * @ingroup TextIO
+     * @class BasicCsvReader
+     * @brief SIMD-accelerated CSV/TSV reader layered on TextReader's buffer.
+     *
+     * Rows are located with simdcsv-style bitmasks: every 64-byte block is
+     * compared against the quote, delimiter and newline bytes at once, and a
+     * prefix XOR over the quote mask tells which structural characters sit
+     * inside quoted fields. Rows are returned as string_views into the read
+     * buffer; only rows crossing a buffer refill and fields containing
+     * escaped quotes ("") are copied.
+     *
+     * @note Quoted fields may contain delimiters, newlines and "" escapes.
+     *       A '\r' before the row's newline is dropped (CRLF input).
+     * @warning Views returned by readRow() are valid until the next call.
+     *
+     * @tparam Allocator Allocator for the pooled buffer (see BasicBufferPool)
+     */
+    template<typename Allocator = std::allocator<char>>
+    class BasicCsvReader {
+    public:
+        /**
+         * @brief Opens a delimited text file for reading.
+         *
+         * @param path        Path to the file
+         * @param delimiter   Field separator (',' for CSV, '\t' for TSV)
+         * @param quote       Quote character
+         * @param bufferSize  Upper bound for the read buffer size
+         * @param compression Decompression layer (Compression::Auto detects it)
+         *
+         * @throws IOException if the file cannot be opened
+         */
+        inline BasicCsvReader(const std::string& path, char delimiter = ',', char quote = '"',
+                              size_t bufferSize = DefaultBufferSize,
+                              Compression compression = Compression::None);
+
+        /**
+         * @brief Reads the next row.
+         *
+         * @param row Receives one view per field, with quotes removed
+         * @return True if a row was read, false at EOF
+         *
+         * @throws IOException on read failure, or if the file ends inside a
+         *         quoted field
+         *
+         * @complexity Amortized O(k), where k is row length
+         */
+        inline bool readRow(std::span<const std::string_view>& row);
+
+    private:
+        inline void scanBlock(size_t start);
+        inline void splitFields(const char* data, size_t length);
+
+        BasicTextReader<Allocator> reader;
+        char delimiter;
+        char quote;
+
+        // Scanner state for the current 64-byte block of reader.buffer
+        size_t blockStart = 0;
+        size_t blockLength = 0;
+        uint64_t pendingDelims = 0;   // unconsumed delimiters outside quotes
+        uint64_t pendingNewlines = 0; // unconsumed newlines outside quotes
+        bool inQuotes = false;        // quote state at the end of the block
+
+        std::vector<size_t> separators; // delimiter offsets relative to row start
+        std::vector<std::string_view> fields;
+        std::string spill;   // row bytes that crossed a buffer refill
+        std::string scratch; // unescaped quoted fields
+    };
+
+    /**
+     * @ingroup TextIO
+     * @brief CsvReader using the standard allocator.
+     */
+    using CsvReader = BasicCsvReader<>;
+
+    template<typename Allocator>
+    inline BasicCsvReader<Allocator>::BasicCsvReader(const std::string& path, char d, char q, size_t bufferSize,
+                                                    Compression compression)
+        : reader(path, bufferSize, compression), delimiter(d), quote(q) {}
+
+    template<typename Allocator>
+    inline void BasicCsvReader<Allocator>::scanBlock(size_t start) {
+        const char* data = reader.buffer.data() + start;
+        size_t length = std::min<size_t>(64, reader.bufferEnd - start);
+
+        alignas(64) char padded[64];
+        if (length < 64) {
+            std::memcpy(padded, data, length);
+            std::memset(padded + length, 0, 64 - length);
+            data = padded;
+        }
+        uint64_t valid = length == 64 ? ~uint64_t(0) : (uint64_t(1) << length) - 1;
+
+        uint64_t quotes = detail::matchMask64(data, quote) & valid;
+        uint64_t inside = detail::prefixXor(quotes) ^ (inQuotes ? ~uint64_t(0) : 0);
+        pendingDelims = detail::matchMask64(data, delimiter) & valid & ~inside;
+        pendingNewlines = detail::matchMask64(data, '\n') & valid & ~inside;
+        inQuotes = (inside >> 63) & 1;
+
+        blockStart = start;
+        blockLength = length;
+    }
+
+    template<typename Allocator>
+    inline bool BasicCsvReader<Allocator>::readRow(std::span<const std::string_view>& row) {
+        if (!reader.file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, reader.path), reader.path);
+
+        separators.clear();
+        spill.clear();
+        size_t rowStart = reader.cursor;
+
+        while (true) {
+            uint64_t structural = pendingDelims | pendingNewlines;
+            if (structural == 0) {
+                size_t next = blockStart + blockLength;
+                if (next < reader.bufferEnd) {
+                    scanBlock(next);
+                    continue;
+                }
+
+                // Row continues past the buffer: keep its bytes and refill
+                spill.append(reader.buffer.data() + rowStart, reader.bufferEnd - rowStart);
+                reader.cursor = reader.bufferEnd;
+                auto bytesRead = reader.fill();
+                if (!bytesRead)
+                    throw IOException(bytesRead.error(), formatIOError(bytesRead.error(), reader.path), reader.path);
+                rowStart = 0;
+                blockStart = blockLength = 0;
+
+                if (*bytesRead == 0) { // EOF: the pending bytes form the last row
+                    if (spill.empty() && separators.empty()) return false;
+                    // A quoted field still open at EOF was cut short
+                    if (inQuotes) reader.throwMalformed(std::string_view(spill).substr(0, 32));
+                    splitFields(spill.data(), spill.size());
+                    break;
+                }
+                continue;
+            }
+
+            int bit = std::countr_zero(structural);
+            uint64_t remaining = bit == 63 ? 0 : ~uint64_t(0) << (bit + 1);
+            bool isNewline = (pendingNewlines >> bit) & 1;
+            pendingDelims &= remaining;
+            pendingNewlines &= remaining;
+
+            size_t position = blockStart + static_cast<size_t>(bit);
+            size_t offset = spill.size() + (position - rowStart);
+            if (!isNewline) {
+                separators.push_back(offset);
+                continue;
+            }
+
+            reader.cursor = position + 1;
+            if (spill.empty()) {
+                splitFields(reader.buffer.data() + rowStart, offset);
+            } else {
+                spill.append(reader.buffer.data() + rowStart, position - rowStart);
+                splitFields(spill.data(), spill.size());
+            }
+            break;
+        }
+
+        row = fields;
+        return true;
+    }
+
+    template<typename Allocator>
+    inline void BasicCsvReader<Allocator>::splitFields(const char* data, size_t length) {
+        if (length > 0 && data[length - 1] == '\r'
+            && (separators.empty() || separators.back() != length - 1))
+            --length; // CRLF row ending
+
+        fields.clear();
+        scratch.clear();
+        scratch.reserve(length); // unescaped fields never outgrow the row: views stay valid
+
+        size_t start = 0;
+        auto emit = [&](size_t end) {
+            std::string_view field(data + start, end - start);
+            if (!field.empty() && field.front() == quote) {
+                field.remove_prefix(1);
+                if (!field.empty() && field.back() == quote) field.remove_suffix(1);
+                if (field.find(quote) != std::string_view::npos) {
+                    // Collapse "" escapes into the scratch buffer
+                    size_t from = scratch.size();
+                    for (size_t i = 0; i < field.size(); ++i) {
+                        scratch.push_back(field[i]);
+                        if (field[i] == quote && i + 1 < field.size() && field[i + 1] == quote) ++i;
+                    }
+                    field = std::string_view(scratch.data() + from, scratch.size() - from);
+                }
+            }
+            fields.push_back(field);
+            start = end + 1;
+        };
+
+        for (size_t separator : separators) emit(separator);
+        emit(length);
+    }
+
+    namespace detail {
+        /**
+         * @brief Last occurrence of @p c in [data, data + n), or nullptr.
+         */
+        inline const char* findLast(const char* data, size_t n, char c) noexcept {
+        #if defined(__GLIBC__)
+            return static_cast<const char*>(::memrchr(data, c, n));
+        #else
+            while (n > 0)
+                if (data[--n] == c) return data + n;
+            return nullptr;
+        #endif
+        }
+    }
+
+    /**
+     * @ingroup TextIO
+     * @class BasicReverseTextReader
+     * @brief Reads the lines of a file from last to first.
+     *
+     * Fixed-size blocks are read backwards from EOF with pread into a pooled
+     * buffer and scanned with memrchr, so reading the last n lines costs
+     * O(n lines) regardless of the file size.
+     *
+     * Lines match BasicTextReader: a final delimiter does not produce an
+     * empty last line.
+     *
+     * @tparam Allocator Allocator for the pooled buffer (see BasicBufferPool)
+     *
+     * @note Compressed files are not supported.
+     */
+    template<typename Allocator = std::allocator<char>>
+    class BasicReverseTextReader {
+    public:
+        /**
+         * @brief Opens a text file for reading backwards.
+         *
+         * @param path       Path to the file
+         * @param bufferSize Size of each block read backwards
+         *
+         * @throws IOException if the file cannot be opened
+         */
+        inline explicit BasicReverseTextReader(const std::string& path, size_t bufferSize = DefaultBufferSize);
+
+        /**
+         * @brief Checks whether a file exists.
+         */
+        inline static bool exists(const std::string& path);
+
+        /**
+         * @brief Reads the line before the previously returned one.
+         *
+         * @param out Receives the line without its delimiter
+         * @return True if a line was read, false once the start of the file is reached
+         *
+         * @throws IOException on read failure
+         *
+         * @complexity Amortized O(k), where k is line length
+         */
+        inline bool readLine(std::string& out);
+
+        /**
+         * @brief Reads the line before the previously returned one.
+         *
+         * @return The line, or an empty string at the start of the file
+         *
+         * @throws IOException on read failure
+         */
+        inline std::string readLine();
+
+        /**
+         * @brief Reads up to @p n further lines and returns them in file order.
+         *
+         * On a fresh reader this is the last n lines of the file.
+         *
+         * @throws IOException on read failure
+         */
+        inline std::vector<std::string> tail(size_t n);
+
+        /**
+         * @brief Sets the byte that terminates a line (default '\n').
+         */
+        void setDelimiter(char c) noexcept { delimiter = c; }
+
+        /**
+         * @brief Strips a '\r' directly preceding each delimiter.
+         */
+        void setStripCR(bool enabled) noexcept { stripCR = enabled; }
+
+    private:
+        inline bool loadPrevious();
+
+        detail::FileHandle file;
+        std::string path;
+        typename BasicBufferPool<Allocator>::Buffer buffer; // pooled read buffer
+        uint64_t bufferStart = 0; // file offset of buffer[0]; everything before it is unread
+        size_t cursor = 0;        // unconsumed bytes are buffer[0, cursor)
+        bool started = false;     // the last block has been loaded
+        bool remaining = false;   // at least one more line precedes the cursor
+        char delimiter = '\n';
+        bool stripCR = false;
+    };
+
+    /**
+     * @ingroup TextIO
+     * @brief ReverseTextReader using the standard allocator.
+     */
+    using ReverseTextReader = BasicReverseTextReader<>;
+
+    template<typename Allocator>
+    inline BasicReverseTextReader<Allocator>::BasicReverseTextReader(const std::string& p, size_t bufferSize)
+        : path(p)
+    {
+        file = detail::FileHandle::open(path, detail::OpenMode::Read, false);
+        if (!file) {
+            IOError code = detail::openError(errno);
+            throw IOException(code, formatIOError(code, path), path);
+        }
+
+        bufferStart = detail::fileSizeHint(path, 0);
+        remaining = bufferStart > 0;
+        buffer = BasicBufferPool<Allocator>::local().acquire(detail::readBufferSize(path, bufferSize));
+    }
+
+    template<typename Allocator>
+    inline bool BasicReverseTextReader<Allocator>::exists(const std::string& path) {
+        return std::filesystem::exists(path);
+    }
+
+    template<typename Allocator>
+    inline bool BasicReverseTextReader<Allocator>::loadPrevious() {
+        if (bufferStart == 0) return false;
+
+        size_t length = static_cast<size_t>(std::min<uint64_t>(bufferStart, buffer.size()));
+        uint64_t start = bufferStart - length;
+        if (detail::preadFull(file, buffer.data(), length, start) != static_cast<ptrdiff_t>(length))
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+        bufferStart = start;
+        cursor = length;
+        return true;
+    }
+
+    template<typename Allocator>
+    inline bool BasicReverseTextReader<Allocator>::readLine(std::string& out) {
+        out.clear();
+        if (!remaining) return false;
+
+        bool terminated = true; // a delimiter follows every line but maybe the last
+        if (!started) {
+            started = true;
+            loadPrevious();
+            terminated = buffer[cursor - 1] == delimiter;
+            if (terminated) --cursor; // ends the last line, does not start one
+        }
+
+        // Pieces arrive right to left. A line spanning several blocks is
+        // built reversed and flipped once, so it costs O(length) overall.
+        size_t pieces = 0;
+        while (true) {
+            const char* found = detail::findLast(buffer.data(), cursor, delimiter);
+            size_t from = found ? static_cast<size_t>(found - buffer.data()) + 1 : 0;
+            const char* begin = buffer.data() + from;
+            const char* end = buffer.data() + cursor;
+            if (pieces++ == 0) {
+                out.append(begin, end);
+            } else {
+                if (pieces == 2) std::reverse(out.begin(), out.end());
+                out.append(std::make_reverse_iterator(end), std::make_reverse_iterator(begin));
+            }
+            if (found) {
+                cursor = from - 1; // the delimiter ends the line before this one
+                break;
+            }
+            cursor = 0;
+            if (!loadPrevious()) {
+                remaining = false; // reached the first line
+                break;
+            }
+        }
+
+        if (pieces > 1) std::reverse(out.begin(), out.end());
+        // Like TextReader, only a '\r' directly before a delimiter is dropped
+        if (stripCR && terminated && !out.empty() && out.back() == '\r') out.pop_back();
+        return true;
+    }
+
+    template<typename Allocator>
+    inline std::string BasicReverseTextReader<Allocator>::readLine() {
+        std::string line;
+        readLine(line);
+        return line;
+    }
+
+    template<typename Allocator>
+    inline std::vector<std::string> BasicReverseTextReader<Allocator>::tail(size_t n) {
+        std::vector<std::string> lines;
+        std::string line;
+        while (lines.size() < n && readLine(line)) lines.push_back(line);
+        std::reverse(lines.begin(), lines.end());
+        return lines;
+    }
+
+    /**
+     * @ingroup TextIO
+     * @class BasicTextWriter
+     * @brief High-performance buffered text file writer.
+     *
+     * Coalesces writes in a reusable internal buffer to minimize
+     * syscall overhead.
+     *
+     * @tparam Allocator Allocator for the pooled buffer (see BasicBufferPool)
+     */
+    template<typename Allocator = std::allocator<char>>
+    class BasicTextWriter {
+    public:
+        /**
+         * @brief Opens a text file for writing.
+         * @param path        File path
+         * @param append      Append instead of overwrite (compressed output
+         *                    starts a new frame, which readers decode seamlessly)
+         * @param bufferSize  Size of the write assembly buffer
+         * @param compression Compression layer (Compression::Auto picks it from
+         *                    the extension: .gz, .zst, .lz4)
+         * @param checksum    Digest computed over the data as it is written (see checksum())
+         * @param trailer     Append the digest (little-endian, 4 or 8 bytes)
+         *                    when the writer is closed
+         * @throws IOException if the file cannot be opened or the format is
+         *         not available in this build
+         */
+        inline BasicTextWriter(const std::string& path, bool append = false,
+                          size_t bufferSize = DefaultBufferSize,
+                          Compression compression = Compression::None,
+                          Checksum checksum = Checksum::None, bool trailer = false);
+
+        /**
+         * @brief Flushes buffers and closes the file; errors are ignored
+         *        (call close() to observe them).
+         */
+        inline ~BasicTextWriter();
+
+        /**
+         * @brief Checks whether a file exists.
+         */
+        inline static bool exists(const std::string& path);
+        
+        /**
+         * @brief Flushes buffered output to disk.
+         */
+        inline void flush();
+
+        /**
+         * @brief Flushes, appends the checksum trailer (if requested) and
+         *        closes the file. The writer cannot be used afterwards.
+         *
+         * @throws IOException on write failure
+         */
+        inline void close();
+
+        /**
+         * @brief Digest of the data handed to the file so far.
+         *
+         * Data still in the write buffer is not included until it is
+         * flushed. Returns 0 with Checksum::None.
+         */
+        uint64_t checksum() const noexcept { return file.checksum(); }
+
+        /**
+         * @brief Writes a raw string to the file.
+         *
+         * @complexity Time: O(n)  
+         * @complexity Space: O(1)
+         *
+         * @throws IOException on write failure
+         */
+        inline void writeString(const std::string& data);
+        
+        /**
+         * @brief Writes a single line with a trailing newline.
+         *
+         * @throws IOException on write failure
+         */
+        inline void writeLine(std::string_view line);
+        
+        /**
+         * @brief Writes multiple lines to the file.
+         *
+         * @complexity Time: O(n)  
+         * @complexity Space: O(n)
+         *
+         * @throws IOException on write failure
+         */
+        inline void writeLines(const std::vector<std::string>& lines);
+
+        /**
+         * @brief Non-throwing variant of writeString().
+         *
+         * @return Nothing on success, otherwise the error category
+         */
+        inline std::expected<void, IOError> tryWrite(std::string_view data) noexcept;
+
+        /**
+         * @brief Writes an integer in decimal, without a separator.
+         *
+         * Converted with std::to_chars directly into the write buffer.
+         *
+         * @throws IOException on write failure
+         */
+        inline void writeInt(int64_t value);
+
+        /**
+         * @brief Writes a double in its shortest round-trip form.
+         *
+         * @throws IOException on write failure
+         */
+        inline void writeDouble(double value);
+
+        /**
+         * @brief Writes a double in fixed notation with the given number of decimals.
+         *
+         * @throws std::invalid_argument if precision is outside [0, 1000]
+         * @throws IOException on write failure
+         */
+        inline void writeFixed(double value, int precision);
+
+        /**
+         * @brief Writes one value per line in shortest round-trip form.
+         *
+         * Checks for buffer room once per value instead of going through
+         * the generic write path, so large result arrays are dumped at
+         * close to to_chars speed.
+         *
+         * @complexity Time: O(n)  
+         * @complexity Space: O(1)
+         *
+         * @throws IOException on write failure
+         */
+        inline void writeColumn(std::span<const double> values);
+
+    #if SFIO_HAS_PRINT
+        /**
+         * @brief Formats straight into the write buffer, like std::print.
+         *
+         * The format string is checked at compile time. Output is produced
+         * with std::format_to_n into the free space of the internal buffer,
+         * so no intermediate std::string is allocated; a record that does
+         * not fit is formatted again after a flush, streaming through the
+         * buffer if it is larger than the buffer itself.
+         *
+         * @throws IOException on write failure
+         *
+         * @note Only declared when SFIO_HAS_PRINT is 1 (the standard library
+         *       implements <format>: libstdc++ 13+, libc++ 17+).
+         */
+        template<typename... Args>
+        inline void print(std::format_string<Args...> fmt, Args&&... args);
+
+        /**
+         * @brief Like print(), followed by a newline.
+         *
+         * @throws IOException on write failure
+         */
+        template<typename... Args>
+        inline void println(std::format_string<Args...> fmt, Args&&... args);
+    #endif
+
+    private:
+        // Upper bound for an integer or shortest-form double plus a newline
+        static constexpr size_t MaxNumberChars = 32;
+
+        inline bool put(const char* data, size_t size) noexcept;
+        inline bool flushBuffer() noexcept;
+        template<typename Convert>
+        inline bool putNumber(Convert convert) noexcept;
+
+    #if SFIO_HAS_PRINT
+        /**
+         * @brief Output iterator appending to the write buffer, flushing when full.
+         */
+        class BufferIterator {
+        public:
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            explicit BufferIterator(BasicTextWriter* owner) : writer(owner) {}
+            BufferIterator& operator*() { return *this; }
+            BufferIterator& operator++() { return *this; }
+            BufferIterator operator++(int) { return *this; }
+            BufferIterator& operator=(char c) {
+                if (writer->used == writer->buffer.size() && !writer->flushBuffer())
+                    throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, writer->path, "Failed to write formatted output."), writer->path);
+                writer->buffer[writer->used++] = c;
+                return *this;
+            }
+
+        private:
+            BasicTextWriter* writer;
+        };
+    #endif
+
+        detail::Stream file;
+        std::string path;
+        bool append = false;
+        typename BasicBufferPool<Allocator>::Buffer buffer; // pooled write assembly buffer
+        size_t used = 0;          // pending bytes in buffer
+    };
+
+    /**
+     * @ingroup TextIO
+     * @brief TextWriter using the standard allocator.
+     */
+    using TextWriter = BasicTextWriter<>;
+
+    template<typename Allocator>
+    inline BasicTextWriter<Allocator>::BasicTextWriter(const std::string& p, bool a, size_t bufferSize,
+                                                      Compression compression, Checksum checksum, bool trailer)
+        : path(p), append(a)
+    {
+        file = detail::Stream::open(path, append ? detail::OpenMode::Append : detail::OpenMode::Write, false);
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        if (!file.setCompression(compression, true, path))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Compression format not available in this build."), path);
+        file.setChecksum(checksum, trailer);
+
+        // Pooled, uninitialized buffer for assembling write payloads
+        buffer = BasicBufferPool<Allocator>::local().acquire(bufferSize);
+    }
+
+    template<typename Allocator>
+    inline BasicTextWriter<Allocator>::~BasicTextWriter() {
+        if (!file) return;
+        // errors are ignored here; call close() to observe them
+        if (flushBuffer()) file.writeTrailer();
+    }
+
+    template<typename Allocator>
+    inline bool BasicTextWriter<Allocator>::exists(const std::string& path) {
+        return std::filesystem::exists(path);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextWriter<Allocator>::flush() {
+        if (!file) return;
+        if (!flushBuffer() || !file.flush())
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to flush file."), path);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextWriter<Allocator>::close() {
+        if (!file) return;
+        bool ok = flushBuffer() && file.writeTrailer();
+        ok = file.close() && ok;
+        if (!ok)
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to close file."), path);
+    }
+
+    template<typename Allocator>
+    inline bool BasicTextWriter<Allocator>::flushBuffer() noexcept {
+        if (used == 0) return true;
+        size_t pending = std::exchange(used, 0);
+        return file.write(buffer.data(), pending);
+    }
+
+    template<typename Allocator>
+    inline bool BasicTextWriter<Allocator>::put(const char* data, size_t size) noexcept {
+        if (size > buffer.size() - used) {
+            if (!flushBuffer()) return false;
+            // Payloads at least as large as the buffer bypass it entirely
+            if (size >= buffer.size()) return file.write(data, size);
+        }
+        std::memcpy(buffer.data() + used, data, size);
+        used += size;
+        return true;
+    }
+
+    template<typename Allocator>
+    inline void BasicTextWriter<Allocator>::writeString(const std::string& data) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        if (!put(data.data(), data.size()))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write string to file."), path);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextWriter<Allocator>::writeLine(std::string_view line) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        if (!put(line.data(), line.size()) || !put("\n", 1))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write line to file."), path);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextWriter<Allocator>::writeLines(const std::vector<std::string>& lines) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        // Lines are packed into the pooled buffer, adding missing newlines
+        for (const auto &line : lines) {
+            bool addNewline = line.empty() || line.back() != '\n';
+            if (!put(line.data(), line.size()) || (addNewline && !put("\n", 1)))
+                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write lines to file."), path);
+        }
+    }
+
+    template<typename Allocator>
+    inline std::expected<void, IOError> BasicTextWriter<Allocator>::tryWrite(std::string_view data) noexcept {
+        if (!file) return std::unexpected(IOError::FileNotOpen);
+        if (!put(data.data(), data.size())) return std::unexpected(IOError::WriteError);
+        return {};
+    }
+
+    template<typename Allocator>
+    template<typename Convert>
+    inline bool BasicTextWriter<Allocator>::putNumber(Convert convert) noexcept {
+        if (buffer.size() - used < MaxNumberChars && !flushBuffer()) return false;
+
+        std::to_chars_result result = convert(buffer.data() + used, buffer.data() + buffer.size());
+        if (result.ec != std::errc()) {
+            // Only long fixed-point output gets here; retry in an empty buffer
+            if (used == 0 || !flushBuffer()) return false;
+            result = convert(buffer.data(), buffer.data() + buffer.size());
+            if (result.ec != std::errc()) return false;
+        }
+        used = static_cast<size_t>(result.ptr - buffer.data());
+        return true;
+    }
+
+    template<typename Allocator>
+    inline void BasicTextWriter<Allocator>::writeInt(int64_t value) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        if (!putNumber([value](char* first, char* last) { return std::to_chars(first, last, value); }))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write number to file."), path);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextWriter<Allocator>::writeDouble(double value) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        if (!putNumber([value](char* first, char* last) { return std::to_chars(first, last, value); }))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write number to file."), path);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextWriter<Allocator>::writeFixed(double value, int precision) {
+        // Bounds the output (at most ~1.3 KB) so it always fits a MinBufferSize buffer
+        if (precision < 0 || precision > 1000)
+            throw std::invalid_argument("Fixed-point precision must be between 0 and 1000.");
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        auto convert = [value, precision](char* first, char* last) {
+            return std::to_chars(first, last, value, std::chars_format::fixed, precision);
+        };
+        if (!putNumber(convert))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write number to file."), path);
+    }
+
+    template<typename Allocator>
+    inline void BasicTextWriter<Allocator>::writeColumn(std::span<const double> values) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        char* const begin = buffer.data();
+        char* const end = begin + buffer.size();
+        for (double value : values) {
+            if (buffer.size() - used < MaxNumberChars && !flushBuffer())
+                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write numbers to file."), path);
+            // Room was checked above, so neither to_chars nor the newline can overflow
+            char* out = std::to_chars(begin + used, end, value).ptr;
+            *out++ = '\n';
+            used = static_cast<size_t>(out - begin);
+        }
+    }
+
+#if SFIO_HAS_PRINT
+    template<typename Allocator>
+    template<typename... Args>
+    inline void BasicTextWriter<Allocator>::print(std::format_string<Args...> fmt, Args&&... args) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        // Common case: the record fits in the free part of the buffer.
+        // Formatting never moves from its arguments, so forwarding twice is safe.
+        size_t room = buffer.size() - used;
+        auto result = std::format_to_n(buffer.data() + used, static_cast<std::ptrdiff_t>(room),
+                                       fmt, std::forward<Args>(args)...);
+        if (static_cast<size_t>(result.size) <= room) {
+            used += static_cast<size_t>(result.size);
+            return;
+        }
+
+        // Truncated: drop the partial output, flush, and stream the record
+        // through the buffer (which flushes again as it fills)
+        if (!flushBuffer())
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write formatted output."), path);
+        std::format_to(BufferIterator(this), fmt, std::forward<Args>(args)...);
+    }
+
+    template<typename Allocator>
+    template<typename... Args>
+    inline void BasicTextWriter<Allocator>::println(std::format_string<Args...> fmt, Args&&... args) {
+        print(fmt, std::forward<Args>(args)...);
+        if (!put("\n", 1))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write formatted output."), path);
+    }
+#endif
+
+    namespace detail {
+        /**
+         * @brief Compresses @p source into @p target and removes @p source.
+         *
+         * The output is written to `<target>.tmp` and renamed into place, so
+         * @p target never exists half-written.
+         *
+         * @throws IOException if a file cannot be read, written or renamed
+         */
+        inline void compressFile(const std::string& source, const std::string& target, Compression compression) {
+            const std::string partial = target + ".tmp";
+            auto in = Stream::open(source, OpenMode::Read, true);
+            if (!in)
+                throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, source), source);
+            auto out = Stream::open(partial, OpenMode::Write, true);
+            if (!out)
+                throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, partial), partial);
+            if (!out.setCompression(compression, true, partial))
+                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, partial, "Compression format not available in this build."), partial);
+
+            auto buffer = BufferPool::local().acquire(DefaultBufferSize);
+            for (ptrdiff_t got; (got = in.read(buffer.data(), buffer.size())) != 0; ) {
+                if (got < 0)
+                    throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, source), source);
+                if (!out.write(buffer.data(), static_cast<size_t>(got)))
+                    throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, partial), partial);
+            }
+            if (!out.close())
+                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, partial), partial);
+
+            std::error_code ec;
+            std::filesystem::rename(partial, target, ec);
+            if (ec)
+                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, target, ec.message()), target);
+            std::filesystem::remove(source, ec);
+        }
+
+        /**
+         * @brief File extension of a compression format (".gz", ".zst", ".lz4").
+         */
+        inline const char* compressionExtension(Compression compression) noexcept {
+            switch (compression) {
+                case Compression::Gzip: return ".gz";
+                case Compression::Zstd: return ".zst";
+                case Compression::Lz4:  return ".lz4";
+                default:                return "";
+            }
+        }
+    }
+
+    /**
+     * @ingroup TextIO
+     * @class BasicRotatingTextWriter
+     * @brief Log writer that rolls over to a new file by size or age.
+     *
+     * Output always goes to @p path. When the file would grow past the size
+     * limit, or is older than the age limit, it is closed and atomically
+     * renamed to `<path>.N` (N one above the highest existing segment) and
+     * a fresh @p path is opened. Rotation happens between writes, so a line
+     * written with writeLine() is never split across segments.
+     *
+     * With compression, closed segments are queued to a background thread
+     * that writes `<path>.N.gz` (or .zst/.lz4) and removes `<path>.N`; the
+     * writing thread only pays for the close, rename and reopen.
+     *
+     * @warning Not safe for concurrent access from multiple threads.
+     *
+     * @tparam Allocator Allocator for the pooled buffer (see BasicBufferPool)
+     */
+    template<typename Allocator = std::allocator<char>>
+    class BasicRotatingTextWriter {
+    public:
+        /**
+         * @brief Opens (appending to) the active log file.
+         * @param path        Active file; segments are named `<path>.N`
+         * @param maxBytes    Rotate before the file would exceed this size (0: no limit)
+         * @param maxAge      Rotate once the file has been open this long (0: no limit)
+         * @param compression Format for closed segments (Compression::None keeps them as is)
+         * @param bufferSize  Size of the write assembly buffer
+         * @throws std::invalid_argument for Compression::Auto
+         * @throws IOException if the file cannot be opened or the format is
+         *         not available in this build
+         */
+        inline BasicRotatingTextWriter(const std::string& path, uint64_t maxBytes,
+                                       std::chrono::seconds maxAge = std::chrono::seconds::zero(),
+                                       Compression compression = Compression::None,
+                                       size_t bufferSize = DefaultBufferSize);
+
+        /**
+         * @brief Flushes and closes the active file and waits for pending
+         *        compression; errors are ignored (call close() to observe them).
+         */
+        inline ~BasicRotatingTextWriter();
+
+        BasicRotatingTextWriter(const BasicRotatingTextWriter&) = delete;
+        BasicRotatingTextWriter& operator=(const BasicRotatingTextWriter&) = delete;
+
+        /**
+         * @brief Writes raw data, rotating first if a limit is reached.
+         *
+         * @throws IOException on write or rotation failure
+         */
+        inline void writeString(std::string_view data);
+
+        /**
+         * @brief Writes a line with a trailing newline, rotating first if a
+         *        limit is reached.
+         *
+         * @throws IOException on write or rotation failure
+         */
+        inline void writeLine(std::string_view line);
+
+        /**
+         * @brief Flushes buffered output of the active file.
+         *
+         * @throws IOException on write failure
+         */
+        inline void flush();
+
+        /**
+         * @brief Closes the current segment now and starts a new one.
+         *
+         * Does nothing while the active file is empty.
+         *
+         * @throws IOException on write or rename failure
+         */
+        inline void rotate();
+
+        /**
+         * @brief Closes the active file and waits until every closed segment
+         *        is compressed. The writer cannot be used afterwards.
+         *
+         * @throws IOException on write failure or if a background
+         *         compression failed
+         */
+        inline void close();
+
+        /**
+         * @brief Bytes in the active file.
+         */
+        uint64_t size() const noexcept { return written; }
+
+    private:
+        inline void rotateIfNeeded(size_t incoming);
+        inline std::string nextSegment();
+        inline void compressLoop();
+        inline void stopCompressor() noexcept;
+
+        using Clock = std::chrono::steady_clock;
+
+        std::string path;
+        uint64_t maxBytes;
+        std::chrono::seconds maxAge;
+        Compression compression;
+        size_t bufferSize;
+        std::optional<BasicTextWriter<Allocator>> writer;
+        uint64_t written = 0;
+        Clock::time_point openedAt;
+        uint64_t sequence = 1;
+
+        // Background compression of closed segments
+        std::thread compressor;
+        std::mutex queueLock;
+        std::condition_variable queueReady;
+        std::deque<std::string> queue;
+        bool stopping = false;
+        std::exception_ptr compressError;
+    };
+
+    /**
+     * @ingroup TextIO
+     * @brief Rotating text writer with the default allocator.
+     */
+    using RotatingTextWriter = BasicRotatingTextWriter<>;
+
+    template<typename Allocator>
+    inline BasicRotatingTextWriter<Allocator>::BasicRotatingTextWriter(const std::string& p, uint64_t bytes,
+                                                                       std::chrono::seconds age,
+                                                                       Compression c, size_t size)
+        : path(p), maxBytes(bytes), maxAge(age), compression(c), bufferSize(size)
+    {
+        if (compression == Compression::Auto)
+            throw std::invalid_argument("Rotating writers need an explicit segment compression.");
+        if (compression != Compression::None && !detail::makeCodec(compression, true))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Compression format not available in this build."), path);
+
+        writer.emplace(path, true, bufferSize);
+        std::error_code ec;
+        written = std::filesystem::file_size(path, ec);
+        if (ec) written = 0;
+        openedAt = Clock::now();
+        if (compression != Compression::None) compressor = std::thread([this] { compressLoop(); });
+    }
+
+    template<typename Allocator>
+    inline BasicRotatingTextWriter<Allocator>::~BasicRotatingTextWriter() {
+        writer.reset(); // errors are ignored here; call close() to observe them
+        stopCompressor();
+    }
+
+    template<typename Allocator>
+    inline void BasicRotatingTextWriter<Allocator>::writeString(std::string_view data) {
+        rotateIfNeeded(data.size());
+        if (!writer->tryWrite(data))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write string to file."), path);
+        written += data.size();
+    }
+
+    template<typename Allocator>
+    inline void BasicRotatingTextWriter<Allocator>::writeLine(std::string_view line) {
+        rotateIfNeeded(line.size() + 1);
+        writer->writeLine(line);
+        written += line.size() + 1;
+    }
+
+    template<typename Allocator>
+    inline void BasicRotatingTextWriter<Allocator>::flush() {
+        if (writer) writer->flush();
+    }
+
+    template<typename Allocator>
+    inline void BasicRotatingTextWriter<Allocator>::rotateIfNeeded(size_t incoming) {
+        if (!writer)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        if (written == 0) return;
+        if ((maxBytes && written + incoming > maxBytes) || (maxAge.count() && Clock::now() - openedAt >= maxAge))
+            rotate();
+    }
+
+    template<typename Allocator>
+    inline std::string BasicRotatingTextWriter<Allocator>::nextSegment() {
+        // Continue after the highest existing <path>.N[.ext], so numbers keep
+        // following time order when older segments were deleted or archived
+        std::filesystem::path active(path);
+        std::filesystem::path directory = active.has_parent_path() ? active.parent_path() : std::filesystem::path(".");
+        const std::string prefix = active.filename().string() + ".";
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+            const std::string name = it->path().filename().string();
+            if (!name.starts_with(prefix)) continue;
+            const char* first = name.data() + prefix.size();
+            const char* last = name.data() + name.size();
+            uint64_t n = 0;
+            auto [stop, error] = std::from_chars(first, last, n);
+            if (error == std::errc() && (stop == last || *stop == '.'))
+                sequence = std::max(sequence, n + 1);
+        }
+        return path + "." + std::to_string(sequence++);
+    }
+
+    template<typename Allocator>
+    inline void BasicRotatingTextWriter<Allocator>::rotate() {
+        if (!writer)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        if (written == 0) return;
+
+        writer->close();
+        writer.reset();
+        std::string segment = nextSegment();
+        std::error_code ec;
+        std::filesystem::rename(path, segment, ec);
+        // Reopen (appending) even if the rename failed, so the writer stays usable
+        writer.emplace(path, true, bufferSize);
+        openedAt = Clock::now();
+        if (ec)
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, segment, ec.message()), segment);
+        written = 0;
+
+        if (compression != Compression::None) {
+            std::lock_guard<std::mutex> lock(queueLock);
+            queue.push_back(std::move(segment));
+            queueReady.notify_one();
+        }
+    }
+
+    template<typename Allocator>
+    inline void BasicRotatingTextWriter<Allocator>::close() {
+        if (writer) {
+            try {
+                writer->close();
+            } catch (...) {
+                writer.reset();
+                stopCompressor();
+                throw;
+            }
+            writer.reset();
+        }
+        stopCompressor();
+        if (compressError) std::rethrow_exception(std::exchange(compressError, nullptr));
+    }
+
+    template<typename Allocator>
+    inline void BasicRotatingTextWriter<Allocator>::compressLoop() {
+        const char* extension = detail::compressionExtension(compression);
+        std::unique_lock<std::mutex> lock(queueLock);
+        while (true) {
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return; // stopping, and every segment is done
+            std::string segment = std::move(queue.front());
+            queue.pop_front();
+
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                detail::compressFile(segment, segment + extension, compression);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+            if (error && !compressError) compressError = error;
+        }
+    }
+
+    template<typename Allocator>
+    inline void BasicRotatingTextWriter<Allocator>::stopCompressor() noexcept {
+        if (!compressor.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            stopping = true;
+        }
+        queueReady.notify_one();
+        compressor.join();
+    }
+
+    namespace detail {
+        /**
+         * @brief Appends the whole of @p source to @p out.
+         *
+         * On Linux the copy stays in the kernel with copy_file_range(2)
+         * (reflinked on filesystems that support it); otherwise, or when the
+         * kernel refuses the pair, a buffered read/write loop is used.
+         *
+         * @return Number of bytes copied
+         * @throws IOException if @p source cannot be read or @p out written
+         */
+        inline uint64_t appendFile(FileHandle& out, const std::string& source, const std::string& target) {
+            auto in = FileHandle::open(source, OpenMode::Read, true);
+            if (!in)
+                throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, source), source);
+            uint64_t copied = 0;
+
+        #if defined(__linux__) && !defined(SFIO_USE_STDIO)
+            while (true) {
+                ssize_t moved = ::copy_file_range(in.native(), nullptr, out.native(), nullptr, 1 << 30, 0);
+                if (moved > 0) {
+                    copied += static_cast<uint64_t>(moved);
+                    continue;
+                }
+                if (moved == 0) return copied;
+                if (errno == EINTR) continue;
+                if (copied == 0 && (errno == EXDEV || errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP))
+                    break; // not supported for this pair; use the buffered loop
+                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, target), target);
+            }
+        #endif
+
+            auto buffer = BufferPool::local().acquire(DefaultBufferSize);
+            for (ptrdiff_t got; (got = in.read(buffer.data(), buffer.size())) != 0; ) {
+                if (got < 0)
+                    throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, source), source);
+                if (!out.write(buffer.data(), static_cast<size_t>(got)))
+                    throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, target), target);
+                copied += static_cast<uint64_t>(got);
+            }
+            return copied;
+        }
+    }
+
+    /**
+     * @ingroup TextIO
+     * @class BasicShardedWriter
+     * @brief Spreads output from many threads over N files.
+     *
+     * Every shard is an independent TextWriter (`<path>.part-N`) with its
+     * own buffer and descriptor, so writers on different shards never
+     * contend. A thread can own a shard outright through shard(); the
+     * writeLine() overloads route round-robin or by key hash and lock only
+     * the chosen shard. concatenate() joins the shards into one file.
+     *
+     * @note Compressed shards concatenate into a valid multi-frame stream.
+     *
+     * @tparam Allocator Allocator for the pooled buffers (see BasicBufferPool)
+     */
+    template<typename Allocator = std::allocator<char>>
+    class BasicShardedWriter {
+    public:
+        /**
+         * @brief Creates (truncating) the shard files.
+         * @param path        Base path; shards are `<path>.part-0` ... `<path>.part-(N-1)`
+         * @param shards      Number of shards; 0 uses one per hardware thread
+         * @param bufferSize  Write buffer size of each shard
+         * @param compression Compression of each shard (Compression::Auto
+         *                    picks it from the extension of @p path)
+         * @throws IOException if a shard cannot be opened
+         */
+        inline BasicShardedWriter(const std::string& path, size_t shards = 0,
+                                  size_t bufferSize = DefaultBufferSize,
+                                  Compression compression = Compression::None);
+
+        /**
+         * @brief Flushes and closes every shard; the shard files are kept.
+         */
+        ~BasicShardedWriter() = default;
+
+        /**
+         * @brief Number of shards.
+         */
+        size_t shardCount() const noexcept { return shards.size(); }
+
+        /**
+         * @brief Path of shard @p index.
+         */
+        const std::string& shardPath(size_t index) const { return shards.at(index)->path; }
+
+        /**
+         * @brief Direct, unsynchronized access to shard @p index.
+         *
+         * For one writer per thread: thread i writes to shard(i) with no
+         * locking at all. Do not mix with the routing writeLine() overloads
+         * on the same shard.
+         *
+         * @throws std::out_of_range for an invalid index
+         */
+        BasicTextWriter<Allocator>& shard(size_t index) { return shards.at(index)->writer; }
+
+        /**
+         * @brief Shard that writeLine(key, line) uses for @p key.
+         */
+        size_t shardFor(std::string_view key) const noexcept {
+            return std::hash<std::string_view>{}(key) % shards.size();
+        }
+
+        /**
+         * @brief Writes a line to the next shard in round-robin order.
+         *
+         * A shard busy with another thread is skipped. Thread-safe.
+         *
+         * @throws IOException on write failure
+         */
+        inline void writeLine(std::string_view line);
+
+        /**
+         * @brief Writes a line to the shard chosen by hashing @p key, so
+         *        equal keys always land in the same shard. Thread-safe.
+         *
+         * @throws IOException on write failure
+         */
+        inline void writeLine(std::string_view key, std::string_view line);
+
+        /**
+         * @brief Flushes and closes every shard.
+         *
+         * @throws IOException on write failure
+         */
+        inline void close();
+
+        /**
+         * @brief Closes the shards and joins them, in shard order, into
+         *        @p target; the shard files are removed afterwards.
+         *
+         * On Linux the data is copied with copy_file_range(2) and never
+         * enters user space.
+         *
+         * @return Size of @p target
+         * @throws IOException if a shard cannot be read or @p target written
+         */
+        inline uint64_t concatenate(const std::string& target);
+
+    private:
+        struct alignas(64) Shard {
+            Shard(const std::string& p, size_t bufferSize, Compression compression)
+                : path(p), writer(p, false, bufferSize, compression) {}
+
+            std::string path;
+            std::mutex lock;
+            BasicTextWriter<Allocator> writer;
+        };
+
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::atomic<size_t> next{0};
+    };
+
+    /**
+     * @ingroup TextIO
+     * @brief Sharded writer with the default allocator.
+     */
+    using ShardedWriter = BasicShardedWriter<>;
+
+    template<typename Allocator>
+    inline BasicShardedWriter<Allocator>::BasicShardedWriter(const std::string& path, size_t count,
+                                                             size_t bufferSize, Compression compression) {
+        if (count == 0) count = std::max(1u, std::thread::hardware_concurrency());
+        if (compression == Compression::Auto) compression = detail::compressionForPath(path);
+        shards.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            shards.push_back(std::make_unique<Shard>(path + ".part-" + std::to_string(i), bufferSize, compression));
+    }
+
+    template<typename Allocator>
+    inline void BasicShardedWriter<Allocator>::writeLine(std::string_view line) {
+        size_t start = next.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < shards.size(); ++i) {
+            Shard& candidate = *shards[(start + i) % shards.size()];
+            std::unique_lock<std::mutex> lock(candidate.lock, std::try_to_lock);
+            if (lock.owns_lock()) {
+                candidate.writer.writeLine(line);
+                return;
+            }
+        }
+        // Every shard is busy: wait for the round-robin choice
+        Shard& chosen = *shards[start % shards.size()];
+        std::lock_guard<std::mutex> lock(chosen.lock);
+        chosen.writer.writeLine(line);
+    }
+
+    template<typename Allocator>
+    inline void BasicShardedWriter<Allocator>::writeLine(std::string_view key, std::string_view line) {
+        Shard& chosen = *shards[shardFor(key)];
+        std::lock_guard<std::mutex> lock(chosen.lock);
+        chosen.writer.writeLine(line);
+    }
+
+    template<typename Allocator>
+    inline void BasicShardedWriter<Allocator>::close() {
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->lock);
+            shard->writer.close();
+        }
+    }
+
+    template<typename Allocator>
+    inline uint64_t BasicShardedWriter<Allocator>::concatenate(const std::string& target) {
+        close();
+        auto out = detail::FileHandle::open(target, detail::OpenMode::Write, true);
+        if (!out)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, target), target);
+        uint64_t total = 0;
+        for (const auto& shard : shards) total += detail::appendFile(out, shard->path, target);
+        if (!out.flush())
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, target), target);
+        out.close();
+
+        std::error_code ec;
+        for (const auto& shard : shards) std::filesystem::remove(shard->path, ec);
+        return total;
+    }
+
+    /**
+     * @ingroup BinaryIO
+     * @class BasicByteReader
+     * @brief High-performance binary file reader.
+     *
+     * Provides efficient sequential access to raw bytes using a pooled
+     * buffer (1 MB by default) to minimize system call overhead.
+     *
+     * @note Intended for large, contiguous binary reads.
+     * @warning Not safe for concurrent access from multiple threads.
+     *
+     * @tparam Allocator Allocator for the pooled buffer (see BasicBufferPool)
+     */
+    template<typename Allocator = std::allocator<char>>
+    class BasicByteReader {
+    public:
+        /**
+         * @brief Opens a binary file for reading.
+         *
+         * @param path        Path to the file
+         * @param bufferSize  Upper bound for the read buffer size
+         * @param compression Decompression layer (Compression::Auto detects it)
+         * @param checksum    Digest computed over the data as it is read (see checksum())
+         * @param trailer     The file ends with a checksum trailer (see
+         *                    BasicByteWriter): it is not returned as data and
+         *                    reaching EOF with a mismatching digest is a read error
+         *
+         * @throws IOException if the file cannot be opened
+         *         (e.g., file does not exist or permission is denied)
+         *         or the format is not available in this build
+         *
+         * @note The file is opened in binary mode ("rb").
+         */
+        inline BasicByteReader(const std::string& path, size_t bufferSize = DefaultBufferSize,
+                               Compression compression = Compression::None,
+                               Checksum checksum = Checksum::None, bool trailer = false);
+
+        /**
+         * @brief Closes the file and releases all associated resources.
+         *
+         * @note Automatically closes the underlying file handle.
+         */
+        inline ~BasicByteReader();
+
+        /**
+         * @brief Checks whether a file exists.
+         *
+         * @param path Path to the file
+         * @return True if the file exists, false otherwise
+         *
+         * @note This function does not verify read permissions.
+         */
+        inline static bool exists(const std::string& path);
+
+        /**
+         * @brief Fraction (0 to 1) of the file's pages in the page cache.
+         *
+         * Asks cachestat(2) on Linux 6.5+ and falls back to mincore(2) over
+         * an untouched mapping; no file data is read. An empty file counts
+         * as fully cached. Without either call the file is reported cold (0).
+         *
+         * @throws IOException if the file cannot be opened
+         */
+        inline static double cachedFraction(const std::string& path) { return detail::cachedFraction(path); }
+
+        /**
+         * @brief Starts loading a byte range into the page cache.
+         *
+         * Returns once the reads are queued (readahead(2), or
+         * POSIX_FADV_WILLNEED), so later reads of the range hit memory.
+         *
+         * @throws IOException if the file cannot be opened
+         */
+        inline static void prefetch(const std::string& path, uint64_t offset = 0,
+                                    uint64_t length = std::numeric_limits<uint64_t>::max()) {
+            detail::prefetch(path, offset, length);
+        }
+
+        /**
+         * @brief Reads the entire file into a byte buffer.
+         *
+         * @return Vector containing all bytes read from the file
+         *
+         * @throws IOException on low-level read failure
+         *
+         * @complexity Time: O(n)  
+         * @complexity Space: O(n)
+         *
+         * @note The returned vector grows dynamically as needed.
+         * @warning Large files will be fully loaded into memory.
+         */
+        inline std::vector<char> readBytes();
+
+        /**
+         * @brief Streams a byte range of the file to another descriptor.
+         *
+         * On Linux the data never enters user space: pipes are fed with
+         * splice(2) and everything else (sockets, files) with sendfile(2).
+         * Otherwise, or when the kernel refuses the descriptor pair, it falls
+         * back to a buffered pread/write loop through the internal buffer.
+         *
+         * @param fd     Destination descriptor (pipe, socket or file)
+         * @param offset Start offset within this file
+         * @param length Number of bytes to send; stops early at EOF
+         * @return Number of bytes transferred
+         *
+         * @throws IOException on read or write failure, or if the reader
+         *         is compressed (offsets refer to the raw file)
+         *
+         * @note Uses positional reads; the sequential read position is unchanged.
+         * @note Non-blocking destinations are waited on with poll().
+         */
+        inline uint64_t streamTo(int fd, uint64_t offset = 0,
+                                 uint64_t length = std::numeric_limits<uint64_t>::max());
+
+        /**
+         * @brief Reads up to dst.size() bytes at the current position.
+         *
+         * Small reads are served from the internal buffer; reads at least as
+         * large as the buffer go straight into @p dst.
+         *
+         * @param dst Destination span
+         * @return Number of bytes read (may be short), 0 at EOF
+         *
+         * @throws IOException on low-level read failure
+         */
+        inline size_t read(std::span<char> dst);
+
+        /**
+         * @brief Non-throwing variant of read().
+         *
+         * @return Number of bytes read (short reads are normal), or
+         *         IOError::EndOfFile when no bytes remain
+         */
+        inline std::expected<size_t, IOError> tryRead(std::span<char> dst) noexcept;
+
+        /**
+         * @brief Digest of the data read from the file so far.
+         *
+         * Computed while bytes are copied through the buffer, so no second
+         * pass is needed: after readBytes() it covers the whole file.
+         * streamTo() uses positional reads and is not included.
+         * Returns 0 with Checksum::None.
+         */
+        uint64_t checksum() const noexcept { return file.checksum(); }
+
+        /**
+         * @brief Moves the read position to byte @p offset of the file.
+         *
+         * If the target is still in the read buffer only the cursor moves;
+         * otherwise the buffer is dropped and the file is repositioned.
+         *
+         * @throws IOException if the file cannot seek (compressed readers,
+         *         checksum trailers) and the target is not buffered
+         *
+         * @complexity O(1)
+         */
+        inline void seek(uint64_t offset);
+
+        /**
+         * @brief Byte offset of the next unread byte.
+         */
+        uint64_t tell() const noexcept { return consumed - (bufferEnd - cursor); }
+
+        /**
+         * @brief Advances the read position by @p bytes.
+         *
+         * Compressed readers decode and discard the skipped data.
+         *
+         * @throws IOException on read or seek failure
+         */
+        inline void skip(uint64_t bytes);
+
+        /**
+         * @brief Reads up to dst.size() bytes at @p offset with pread.
+         *
+         * Leaves the buffer and the read position alone, so concurrent calls
+         * on one reader are safe (except with SFIO_USE_STDIO, which emulates
+         * pread).
+         *
+         * @return Bytes read; short only at EOF
+         *
+         * @throws IOException on read failure or for compressed readers
+         */
+        inline size_t readAt(uint64_t offset, std::span<char> dst);
+
+    private:
+        detail::Stream file;
+        std::string path;
+        typename BasicBufferPool<Allocator>::Buffer buffer; // pooled read buffer
+        size_t cursor = 0;        // current position in buffer
+        size_t bufferEnd = 0;     // end of valid data in buffer
+        uint64_t consumed = 0;    // bytes read from the file; buffer ends here
+    };
+
+    /**
+     * @ingroup BinaryIO
+     * @brief ByteReader using the standard allocator.
+     */
+    using ByteReader = BasicByteReader<>;
+
+    template<typename Allocator>
+    inline BasicByteReader<Allocator>::BasicByteReader(const std::string& p, size_t bufferSize, Compression compression,
+                                                      Checksum checksum, bool trailer)
+        : path(p)
+    {
+        file = detail::Stream::open(path, detail::OpenMode::Read, true);
+        if (!file) {
+            IOError code = detail::openError(errno);
+            throw IOException(code, formatIOError(code, path), path);
+        }
+        if (!file.setCompression(compression, false, path))
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path, "Compression format not available in this build."), path);
+        file.setChecksum(checksum, trailer);
+
+        // Pooled, uninitialized buffer; small files get a small buffer
+        // (decompressed data outgrows the file, so keep the full size then)
+        buffer = BasicBufferPool<Allocator>::local().acquire(
+            file.compressed() ? bufferSize : detail::readBufferSize(path, bufferSize));
+    }
+
+    template<typename Allocator>
+    inline BasicByteReader<Allocator>::~BasicByteReader() {
+        // FileHandle closes the file
+    }
+
+    template<typename Allocator>
+    inline bool BasicByteReader<Allocator>::exists(const std::string& path) {
+        return std::filesystem::exists(path);
+    }
+
+    template<typename Allocator>
+    inline std::vector<char> BasicByteReader<Allocator>::readBytes() {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        // Start with whatever is still buffered, then read straight into the
+        // result; +1 leaves room for the EOF probe
+        std::vector<char> data;
+        data.reserve(detail::fileSizeHint(path, 4 << 20) + 1); // exact size when known
+        data.insert(data.end(), buffer.data() + cursor, buffer.data() + bufferEnd);
+        cursor = bufferEnd = 0;
+
+        while (true) {
+            size_t used = data.size();
+            size_t room = data.capacity() - used;
+            data.resize(used + (room > 0 ? room : buffer.size()));
+            ptrdiff_t bytesRead = file.read(data.data() + used, data.size() - used);
+            if (bytesRead < 0)
+                throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+            data.resize(used + static_cast<size_t>(bytesRead));
+            consumed += static_cast<uint64_t>(bytesRead);
+            if (bytesRead == 0) break;
+        }
+
+        return data;
+    }
+
+    template<typename Allocator>
+    inline uint64_t BasicByteReader<Allocator>::streamTo(int fd, uint64_t offset, uint64_t length) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        uint64_t sent = 0;
+
+    #if defined(__linux__) && !defined(SFIO_USE_STDIO)
+        struct stat target;
+        bool toPipe = ::fstat(fd, &target) == 0 && S_ISFIFO(target.st_mode);
+        bool zeroCopy = file.native() >= 0; // compressed streams have no descriptor
+
+        while (zeroCopy && sent < length) {
+            size_t chunk = static_cast<size_t>(std::min<uint64_t>(length - sent, 1 << 30));
+            loff_t pos = static_cast<loff_t>(offset + sent);
+            ssize_t moved = toPipe
+                ? ::splice(file.native(), &pos, fd, nullptr, chunk, SPLICE_F_MOVE | SPLICE_F_MORE)
+                : ::sendfile(fd, file.native(), &pos, chunk);
+            if (moved > 0) {
+                sent += static_cast<uint64_t>(moved);
+                continue;
+            }
+            if (moved == 0) return sent; // EOF
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) {
+                detail::waitWritable(fd);
+                continue;
+            }
+            if (sent == 0 && (errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP))
+                zeroCopy = false; // descriptor pair not supported; use the buffered loop
+            else
+                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to stream file to descriptor."), path);
+        }
+    #endif
+
+        while (sent < length) {
+            size_t chunk = static_cast<size_t>(std::min<uint64_t>(length - sent, buffer.size()));
+            ptrdiff_t got = file.pread(buffer.data(), chunk, offset + sent);
+            if (got < 0)
+                throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+            if (got == 0) break;
+            if (!detail::writeToDescriptor(fd, buffer.data(), static_cast<size_t>(got)))
+                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to stream file to descriptor."), path);
+            sent += static_cast<uint64_t>(got);
+        }
+        return sent;
+    }
+
+    template<typename Allocator>
+    inline std::expected<size_t, IOError> BasicByteReader<Allocator>::tryRead(std::span<char> dst) noexcept {
+        if (!file) return std::unexpected(IOError::FileNotOpen);
+        if (dst.empty()) return 0;
+
+        if (cursor == bufferEnd) {
+            // Large reads bypass the buffer entirely
+            if (dst.size() >= buffer.size()) {
+                ptrdiff_t bytesRead = file.read(dst.data(), dst.size());
+                if (bytesRead < 0) return std::unexpected(IOError::ReadError);
+                if (bytesRead == 0) return std::unexpected(IOError::EndOfFile);
+                consumed += static_cast<uint64_t>(bytesRead);
+                cursor = bufferEnd = 0; // the buffer no longer ends at the file position
+                return static_cast<size_t>(bytesRead);
+            }
+
+            ptrdiff_t bytesRead = file.read(buffer.data(), buffer.size());
+            if (bytesRead < 0) return std::unexpected(IOError::ReadError);
+            if (bytesRead == 0) return std::unexpected(IOError::EndOfFile);
+            consumed += static_cast<uint64_t>(bytesRead);
+            cursor = 0;
+            bufferEnd = static_cast<size_t>(bytesRead);
+        }
+
+        size_t n = std::min(dst.size(), bufferEnd - cursor);
+        std::memcpy(dst.data(), buffer.data() + cursor, n);
+        cursor += n;
+        return n;
+    }
+
+    template<typename Allocator>
+    inline void BasicByteReader<Allocator>::seek(uint64_t offset) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        // The buffer holds the file bytes [consumed - bufferEnd, consumed)
+        uint64_t bufferStart = consumed - bufferEnd;
+        if (offset >= bufferStart && offset <= consumed) {
+            cursor = static_cast<size_t>(offset - bufferStart);
+            return;
+        }
+        if (!file.seek(offset))
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path, "Failed to seek."), path);
+        cursor = bufferEnd = 0;
+        consumed = offset;
+    }
+
+    template<typename Allocator>
+    inline void BasicByteReader<Allocator>::skip(uint64_t bytes) {
+        if (!file.compressed()) {
+            seek(tell() + bytes);
+            return;
+        }
+
+        while (bytes > 0) {
+            if (cursor == bufferEnd) {
+                ptrdiff_t bytesRead = file.read(buffer.data(), buffer.size());
+                if (bytesRead < 0)
+                    throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+                if (bytesRead == 0) return; // skipping past EOF stops at EOF
+                consumed += static_cast<uint64_t>(bytesRead);
+                cursor = 0;
+                bufferEnd = static_cast<size_t>(bytesRead);
+            }
+            size_t take = static_cast<size_t>(std::min<uint64_t>(bytes, bufferEnd - cursor));
+            cursor += take;
+            bytes -= take;
+        }
+    }
+
+    template<typename Allocator>
+    inline size_t BasicByteReader<Allocator>::readAt(uint64_t offset, std::span<char> dst) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        ptrdiff_t got = detail::preadFull(file, dst.data(), dst.size(), offset);
+        if (got < 0)
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+        return static_cast<size_t>(got);
+    }
+
+    template<typename Allocator>
+    inline size_t BasicByteReader<Allocator>::read(std::span<char> dst) {
+        auto bytesRead = tryRead(dst);
+        if (bytesRead) return *bytesRead;
+        if (bytesRead.error() == IOError::EndOfFile) return 0;
+        throw IOException(bytesRead.error(), formatIOError(bytesRead.error(), path), path);
+    }
+
+    /**
+     * @ingroup BinaryIO
+     * @class BasicByteWriter
+     * @brief High-performance binary file writer.
+     *
+     * Writes raw byte buffers efficiently, coalescing small writes in an
+     * internal buffer to minimize system calls.
+     *
+     * @note Buffered data reaches the file on flush() or destruction.
+     * @warning Not safe for concurrent access from multiple threads.
+     *
+     * @tparam Allocator Allocator for the pooled buffer (see BasicBufferPool)
+     */
+    template<typename Allocator = std::allocator<char>>
+    class BasicByteWriter {
+    public:
+        /**
+         * @brief Opens a binary file for writing.
+         *
+         * @param path        Path to the file
+         * @param append      If true, appends to the file instead of overwriting
+         * @param bufferSize  Size of the write assembly buffer
+         * @param compression Compression layer (Compression::Auto picks it from
+         *                    the extension: .gz, .zst, .lz4)
+         * @param checksum    Digest computed over the data as it is written (see checksum())
+         * @param trailer     Append the digest (little-endian, 4 or 8 bytes)
+         *                    when the writer is closed
+         *
+         * @throws IOException if the file cannot be opened or the format is
+         *         not available in this build
+         *
+         * @note The file is opened in binary mode ("wb" or "ab").
+         */
+        inline BasicByteWriter(const std::string& path, bool append = false,
+                          size_t bufferSize = DefaultBufferSize,
+                          Compression compression = Compression::None,
+                          Checksum checksum = Checksum::None, bool trailer = false);
+
+        /**
+         * @brief Flushes buffered output and closes the file.
+         *
+         * @note Destructor ensures that all pending data is flushed to disk;
+         *       errors are ignored (call close() to observe them).
+         */
+        inline ~BasicByteWriter();
+
+        /**
+         * @brief Checks whether a file exists.
+         *
+         * @param path Path to the file
+         * @return True if the file exists, false otherwise
+         */
+        inline static bool exists(const std::string& path);
+
+        /**
+         * @brief Flushes any buffered output to disk.
+         *
+         * @throws IOException on flush failure
+         *
+         * @note This does not close the file.
+         */
+        inline void flush();
+
+        /**
+         * @brief Flushes, appends the checksum trailer (if requested) and
+         *        closes the file. The writer cannot be used afterwards.
+         *
+         * @throws IOException on write failure
+         */
+        inline void close();
+
+        /**
+         * @brief Digest of the data handed to the file so far.
+         *
+         * Data still in the write buffer is not included until it is
+         * flushed. Returns 0 with Checksum::None.
+         */
+        uint64_t checksum() const noexcept { return file.checksum(); }
+
+        /**
+         * @brief Writes a byte buffer to the file.
+         *
+         * Small payloads are coalesced in the internal buffer; payloads at
+         * least as large as the buffer are written directly.
+         *
+         * @param data Byte buffer to write
+         *
+         * @throws IOException on write failure
+         *
+         * @complexity Time: O(n)  
+         * @complexity Space: O(1)
+         *
+         * @note Short writes are retried; any other failure throws.
+         */
+        inline void writeBytes(const std::vector<char>& data);
+
+        /**
+         * @brief Non-throwing variant of writeBytes().
+         *
+         * @return Nothing on success, otherwise the error category
+         */
+        inline std::expected<void, IOError> tryWrite(std::span<const char> data) noexcept;
+
+    private:
+        inline bool put(const char* data, size_t size) noexcept;
+        inline bool flushBuffer() noexcept;
+
+        detail::Stream file;
+        std::string path;
+        bool append = false;
+        typename BasicBufferPool<Allocator>::Buffer buffer; // pooled write assembly buffer
+        size_t used = 0;          // pending bytes in buffer
+    };
+
+    /**
+     * @ingroup BinaryIO
+     * @brief ByteWriter using the standard allocator.
+     */
+    using ByteWriter = BasicByteWriter<>;
+
+    template<typename Allocator>
+    inline BasicByteWriter<Allocator>::BasicByteWriter(const std::string& p, bool a, size_t bufferSize,
+                                                      Compression compression, Checksum checksum, bool trailer)
+        : path(p), append(a)
+    {
+        file = detail::Stream::open(path, append ? detail::OpenMode::Append : detail::OpenMode::Write, true);
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        if (!file.setCompression(compression, true, path))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Compression format not available in this build."), path);
+        file.setChecksum(checksum, trailer);
+
+        // Pooled, uninitialized buffer for assembling write payloads
+        buffer = BasicBufferPool<Allocator>::local().acquire(bufferSize);
+    }
+
+    template<typename Allocator>
+    inline BasicByteWriter<Allocator>::~BasicByteWriter() {
+        if (!file) return;
+        // errors are ignored here; call close() to observe them
+        if (flushBuffer()) file.writeTrailer();
+    }
+
+    template<typename Allocator>
+    inline bool BasicByteWriter<Allocator>::exists(const std::string& path) {
+        return std::filesystem::exists(path);
+    }
+
+    template<typename Allocator>
+    inline void BasicByteWriter<Allocator>::flush() {
+        if (!file) return;
+        if (!flushBuffer() || !file.flush())
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to flush file."), path);
+    }
+
+    template<typename Allocator>
+    inline void BasicByteWriter<Allocator>::close() {
+        if (!file) return;
+        bool ok = flushBuffer() && file.writeTrailer();
+        ok = file.close() && ok;
+        if (!ok)
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to close file."), path);
+    }
+
+    template<typename Allocator>
+    inline bool BasicByteWriter<Allocator>::flushBuffer() noexcept {
+        if (used == 0) return true;
+        size_t pending = std::exchange(used, 0);
+        return file.write(buffer.data(), pending);
+    }
+
+    template<typename Allocator>
+    inline bool BasicByteWriter<Allocator>::put(const char* data, size_t size) noexcept {
+        if (size > buffer.size() - used) {
+            if (!flushBuffer()) return false;
+            // Payloads at least as large as the buffer bypass it entirely
+            if (size >= buffer.size()) return file.write(data, size);
+        }
+        std::memcpy(buffer.data() + used, data, size);
+        used += size;
+        return true;
+    }
+
+    template<typename Allocator>
+    inline void BasicByteWriter<Allocator>::writeBytes(const std::vector<char>& data) {
         if (!file)
             throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
-        if (lines.empty()) return;
 
-        // Compute total size: sum of line sizes + missing newlines for lines that don't end with '\n'
-        size_t totalSize = 0;
-        size_t missingNewlines = 0;
-        for (const auto &line : lines) {
-            totalSize += line.size();
-            if (line.empty() || line.back() != '\n') ++missingNewlines;
+        if (!put(data.data(), data.size()))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write bytes to file."), path);
+    }
+
+    template<typename Allocator>
+    inline std::expected<void, IOError> BasicByteWriter<Allocator>::tryWrite(std::span<const char> data) noexcept {
+        if (!file) return std::unexpected(IOError::FileNotOpen);
+        if (!put(data.data(), data.size())) return std::unexpected(IOError::WriteError);
+        return {};
+    }
+
+    namespace detail {
+        /**
+         * @brief Magic of the LineIndex sidecar format.
+         */
+        inline constexpr char LineIndexMagic[8] = {'S', 'F', 'I', 'O', 'L', 'I', 'X', '1'};
+
+        /**
+         * @brief Size of each parallel whole-file scan chunk (8 MB).
+         */
+        inline constexpr size_t ScanChunk = 8 << 20;
+
+        /**
+         * @brief Reads @p path in ScanChunk pieces on worker threads.
+         *
+         * Each chunk is filled by a positional read into a pooled buffer and
+         * handed to fn(base, data, length), whose return value is kept in
+         * chunk order.
+         *
+         * @return The file size and the per-chunk results
+         * @throws IOException if the file cannot be opened or read
+         */
+        template <typename Result, typename Fn>
+        inline std::pair<uint64_t, std::vector<Result>> scanChunks(const std::string& path, unsigned threads, Fn&& fn) {
+            auto file = FileHandle::open(path, OpenMode::Read, true);
+            if (!file)
+                throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+            std::error_code ec;
+            uint64_t size = std::filesystem::file_size(path, ec);
+            if (ec)
+                throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path, ec.message()), path);
+
+            size_t chunks = static_cast<size_t>((size + ScanChunk - 1) / ScanChunk);
+            std::vector<Result> results(chunks);
+            parallelFor(chunks, preadThreads(threads), [&](size_t chunk) {
+                uint64_t base = uint64_t(chunk) * ScanChunk;
+                size_t length = static_cast<size_t>(std::min<uint64_t>(ScanChunk, size - base));
+                auto buffer = BufferPool::local().acquire(length);
+                if (preadFull(file, buffer.data(), length, base) != static_cast<ptrdiff_t>(length))
+                    throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+                results[chunk] = fn(base, static_cast<const char*>(buffer.data()), length);
+            });
+            return {size, std::move(results)};
+        }
+
+        /**
+         * @brief Extra bytes read per step when completing a chunk's last line.
+         */
+        inline constexpr size_t ScanLineTail = 64 << 10;
+
+        /**
+         * @brief Like scanChunks, but hands each chunk only whole lines.
+         *
+         * A chunk owns the lines starting inside it: one byte before it is
+         * read to tell whether a line starts at its first byte, and reading
+         * continues past its end until its last line is complete. The stride
+         * leaves room for that byte and ScanLineTail bytes of tail in the
+         * ScanChunk-sized pooled buffer; only a line needing more than that
+         * moves to a larger pooled buffer.
+         * fn(offset, data, length) receives the file offset of the first
+         * owned line; a chunk owning no line start keeps a default Result.
+         *
+         * @return The file size and the per-chunk results
+         * @throws IOException if the file cannot be opened or read
+         */
+        template <typename Result, typename Allocator = std::allocator<char>, typename Fn>
+        inline std::pair<uint64_t, std::vector<Result>> scanLineChunks(const std::string& path, unsigned threads,
+                                                                       Fn&& fn) {
+            auto file = FileHandle::open(path, OpenMode::Read, true);
+            if (!file)
+                throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+            std::error_code ec;
+            uint64_t size = std::filesystem::file_size(path, ec);
+            if (ec)
+                throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path, ec.message()), path);
+            auto readAt = [&](char* dst, size_t length, uint64_t offset) {
+                if (preadFull(file, dst, length, offset) != static_cast<ptrdiff_t>(length))
+                    throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+            };
+
+            constexpr size_t stride = ScanChunk - ScanLineTail - 1; // minus the byte before each chunk
+            size_t chunks = static_cast<size_t>((size + stride - 1) / stride);
+            std::vector<Result> results(chunks);
+            parallelFor(chunks, preadThreads(threads), [&](size_t chunk) {
+                uint64_t base = uint64_t(chunk) * stride;
+                uint64_t readFrom = base > 0 ? base - 1 : 0;
+                uint64_t chunkEnd = std::min<uint64_t>(base + stride, size);
+                size_t length = static_cast<size_t>(chunkEnd - readFrom);
+                auto buffer = BasicBufferPool<Allocator>::local().acquire(ScanChunk);
+                readAt(buffer.data(), length, readFrom);
+
+                size_t begin = 0;
+                if (base > 0) {
+                    auto first = static_cast<const char*>(std::memchr(buffer.data(), '\n', length - 1));
+                    if (!first) return; // one line spans the whole chunk
+                    begin = static_cast<size_t>(first - buffer.data()) + 1;
+                }
+                size_t end = length; // start of the first line owned by the next chunk
+                if (buffer[end - 1] != '\n') {
+                    for (uint64_t at = chunkEnd; at < size; ) {
+                        size_t step = static_cast<size_t>(std::min<uint64_t>(ScanLineTail, size - at));
+                        if (end + step > buffer.size()) {
+                            auto larger = BasicBufferPool<Allocator>::local().acquire(end + step);
+                            std::memcpy(larger.data(), buffer.data(), end);
+                            buffer = std::move(larger);
+                        }
+                        readAt(buffer.data() + end, step, at);
+                        at += step;
+                        if (auto nl = static_cast<const char*>(std::memchr(buffer.data() + end, '\n', step))) {
+                            end = static_cast<size_t>(nl - buffer.data()) + 1;
+                            break;
+                        }
+                        end += step;
+                    }
+                }
+                results[chunk] = fn(readFrom + begin, static_cast<const char*>(buffer.data()) + begin, end - begin);
+            });
+            return {size, std::move(results)};
+        }
+
+        inline void storeLE(char* p, uint64_t value, int bytes) noexcept {
+            for (int i = 0; i < bytes; ++i) p[i] = static_cast<char>(value >> (8 * i));
+        }
+
+        inline uint64_t loadLE(const char* p, int bytes) noexcept {
+            uint64_t value = 0;
+            for (int i = 0; i < bytes; ++i) value |= uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+            return value;
+        }
+    }
+
+    inline LineIndex LineIndex::build(const std::string& path, char delimiter, unsigned threads) {
+        // Each chunk collects the offsets just past its delimiters
+        auto [size, found] = detail::scanChunks<std::vector<uint64_t>>(path, threads,
+            [delimiter](uint64_t base, const char* data, size_t length) {
+                std::vector<uint64_t> starts;
+                size_t i = 0;
+                for (; i + 64 <= length; i += 64) {
+                    for (uint64_t mask = detail::matchMask64(data + i, delimiter); mask; mask &= mask - 1)
+                        starts.push_back(base + i + static_cast<size_t>(std::countr_zero(mask)) + 1);
+                }
+                for (; i < length; ++i)
+                    if (data[i] == delimiter) starts.push_back(base + i + 1);
+                return starts;
+            });
+
+        LineIndex index;
+        index.separator = delimiter;
+        size_t total = 0;
+        for (const auto& starts : found) total += starts.size();
+        index.offsets.reserve(total + 2);
+        for (const auto& starts : found)
+            index.offsets.insert(index.offsets.end(), starts.begin(), starts.end());
+        // A final delimiter ends the last line instead of starting an empty one
+        if (index.offsets.back() != size) index.offsets.push_back(size);
+        return index;
+    }
+
+    inline void LineIndex::save(const std::string& indexPath) const {
+        std::vector<char> data(32);
+        std::memcpy(data.data(), detail::LineIndexMagic, sizeof(detail::LineIndexMagic));
+        detail::storeLE(data.data() + 8, fileSize(), 8);
+        detail::storeLE(data.data() + 16, lineCount(), 8);
+        data[24] = separator;
+        data.reserve(data.size() + 2 * lineCount());
+
+        for (size_t n = 0; n < lineCount(); ++n) {
+            uint64_t length = offsets[n + 1] - offsets[n];
+            do {
+                char byte = static_cast<char>(length & 0x7F);
+                length >>= 7;
+                data.push_back(static_cast<char>(byte | (length ? 0x80 : 0)));
+            } while (length);
+        }
+
+        ByteWriter fWrite(indexPath);
+        fWrite.writeBytes(data);
+        fWrite.close();
+    }
+
+    inline LineIndex LineIndex::load(const std::string& indexPath) {
+        std::vector<char> data = ByteReader(indexPath).readBytes();
+        auto invalid = [&] {
+            return IOException(IOError::ReadError, formatIOError(IOError::ReadError, indexPath, "Not a valid line index."), indexPath);
+        };
+        if (data.size() < 32 || std::memcmp(data.data(), detail::LineIndexMagic, sizeof(detail::LineIndexMagic)) != 0)
+            throw invalid();
+
+        uint64_t size = detail::loadLE(data.data() + 8, 8);
+        uint64_t count = detail::loadLE(data.data() + 16, 8);
+        if (count > data.size() - 32) throw invalid(); // every line takes at least one byte
+
+        LineIndex index;
+        index.separator = data[24];
+        index.offsets.reserve(static_cast<size_t>(count) + 1);
+        const char* p = data.data() + 32;
+        const char* end = data.data() + data.size();
+        for (uint64_t n = 0; n < count; ++n) {
+            uint64_t length = 0;
+            for (int shift = 0; ; shift += 7) {
+                if (p == end || shift > 63) throw invalid();
+                auto byte = static_cast<unsigned char>(*p++);
+                length |= uint64_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) break;
+            }
+            index.offsets.push_back(index.offsets.back() + length);
+        }
+        if (p != end || index.offsets.back() != size) throw invalid();
+        return index;
+    }
+
+    /**
+     * @ingroup TextIO
+     * @struct SearchMatch
+     * @brief A line containing at least one search pattern.
+     */
+    struct SearchMatch {
+        uint64_t line = 0;    ///< Zero-based line number
+        uint64_t offset = 0;  ///< Byte offset of the line start
+        size_t pattern = 0;   ///< Index of the leftmost pattern found in the line
+        std::string text;     ///< The line without its '\n'
+    };
+
+    namespace detail {
+        /**
+         * @brief Multi-literal matcher using first/last byte SIMD fingerprints.
+         *
+         * For every 64-byte window each pattern contributes the mask of
+         * positions whose first byte and last byte (at +length-1) both match
+         * (matchMask64, AVX2/SSE2 when available). Only those candidates are
+         * verified with memcmp, so text without near-matches is skipped at
+         * vector speed.
+         */
+        class LiteralMatcher {
+        public:
+            explicit LiteralMatcher(std::vector<std::string> list) : patterns(std::move(list)) {
+                if (patterns.empty() || patterns.size() > MaxPatterns)
+                    throw std::invalid_argument("Search needs 1 to 64 patterns.");
+                for (const auto& pattern : patterns) {
+                    if (pattern.empty() || pattern.size() > 64)
+                        throw std::invalid_argument("Search patterns must be 1 to 64 bytes.");
+                    if (pattern.find('\n') != std::string::npos)
+                        throw std::invalid_argument("Search patterns cannot contain a newline.");
+                    longest = std::max(longest, pattern.size());
+                }
+            }
+
+            /**
+             * @brief Leftmost match at or after @p from in [data, data + n).
+             * @return Match position and pattern index, or npos
+             */
+            inline std::pair<size_t, size_t> find(const char* data, size_t n, size_t from) const noexcept;
+
+            static constexpr size_t npos = static_cast<size_t>(-1);
+            static constexpr size_t MaxPatterns = 64;
+
+        private:
+            bool matchesAt(const char* p, size_t k) const noexcept {
+                const std::string& pattern = patterns[k];
+                return std::memcmp(p, pattern.data(), pattern.size()) == 0;
+            }
+
+            std::vector<std::string> patterns;
+            size_t longest = 0;
+        };
+
+        inline std::pair<size_t, size_t> LiteralMatcher::find(const char* data, size_t n, size_t from) const noexcept {
+            size_t i = from;
+            // Windows whose last-byte loads stay in bounds for every pattern
+            for (; i + 64 + longest - 1 <= n; i += 64) {
+                uint64_t candidates[MaxPatterns];
+                uint64_t any = 0;
+                for (size_t k = 0; k < patterns.size(); ++k) {
+                    const std::string& pattern = patterns[k];
+                    candidates[k] = matchMask64(data + i, pattern.front())
+                                  & matchMask64(data + i + pattern.size() - 1, pattern.back());
+                    any |= candidates[k];
+                }
+
+                for (; any; any &= any - 1) {
+                    size_t bit = static_cast<size_t>(std::countr_zero(any));
+                    for (size_t k = 0; k < patterns.size(); ++k)
+                        if ((candidates[k] >> bit & 1) && matchesAt(data + i + bit, k)) return {i + bit, k};
+                }
+            }
+            for (; i < n; ++i)
+                for (size_t k = 0; k < patterns.size(); ++k)
+                    if (patterns[k].size() <= n - i && matchesAt(data + i, k)) return {i, k};
+            return {npos, 0};
+        }
+
+    }
+
+    /**
+     * @ingroup TextIO
+     * @brief Finds every line of a file containing any of @p patterns.
+     *
+     * The file is split into chunks of about 8 MB scanned on worker threads
+     * with positional reads into pooled buffers; each chunk owns the lines
+     * starting inside it. Only matching lines are copied out. Matches are
+     * returned in file order.
+     *
+     * @param path     File to search
+     * @param patterns 1 to 64 literal patterns (each 1 to 64 bytes, no newline)
+     * @param threads  Thread count; 0 uses all hardware threads
+     *
+     * @throws std::invalid_argument for too many patterns or empty, overlong
+     *         or multi-line ones
+     * @throws IOException if the file cannot be opened or read
+     *
+     * @note Compressed files are not supported.
+     */
+    inline std::vector<SearchMatch> searchFile(const std::string& path, const std::vector<std::string>& patterns,
+                                               unsigned threads = 0) {
+        const detail::LiteralMatcher matcher(patterns);
+        struct ChunkResult {
+            std::vector<SearchMatch> matches; // line numbers relative to the chunk
+            uint64_t lines = 0;               // lines starting in the chunk
+        };
+        auto results = detail::scanLineChunks<ChunkResult>(path, threads,
+            [&](uint64_t offset, const char* text, size_t length) {
+                ChunkResult result;
+                size_t counted = 0; // line numbers are counted up to here
+                uint64_t line = 0;
+                for (size_t from = 0; from < length; ) {
+                    auto [pos, which] = matcher.find(text, length, from);
+                    if (pos == detail::LiteralMatcher::npos) break;
+                    auto lineStart = detail::findLast(text, pos, '\n');
+                    size_t start = lineStart ? static_cast<size_t>(lineStart - text) + 1 : 0;
+                    auto lineEnd = static_cast<const char*>(std::memchr(text + pos, '\n', length - pos));
+                    size_t end = lineEnd ? static_cast<size_t>(lineEnd - text) : length;
+
+                    line += detail::countByte(text + counted, start - counted, '\n');
+                    counted = start;
+                    result.matches.push_back({line, offset + start, which, std::string(text + start, end - start)});
+                    from = end + 1;
+                }
+                result.lines = detail::countByte(text, length, '\n')
+                             + (length > 0 && text[length - 1] != '\n'); // unterminated last line
+                return result;
+            }).second;
+
+        std::vector<SearchMatch> matches;
+        uint64_t linesBefore = 0;
+        for (auto& result : results) {
+            for (auto& match : result.matches) {
+                match.line += linesBefore;
+                matches.push_back(std::move(match));
+            }
+            linesBefore += result.lines;
+        }
+        return matches;
+    }
+
+    /**
+     * @ingroup TextIO
+     * @brief Finds every line of a file containing @p pattern.
+     *
+     * @throws std::invalid_argument for an empty, overlong or multi-line pattern
+     * @throws IOException if the file cannot be opened or read
+     */
+    inline std::vector<SearchMatch> searchFile(const std::string& path, std::string_view pattern, unsigned threads = 0) {
+        return searchFile(path, std::vector<std::string>{std::string(pattern)}, threads);
+    }
+
+    /**
+     * @ingroup TextIO
+     * @brief Braced-list form: `searchFile(path, {"ERROR", "timeout"})`.
+     */
+    inline std::vector<SearchMatch> searchFile(const std::string& path, std::initializer_list<std::string> patterns,
+                                               unsigned threads = 0) {
+        return searchFile(path, std::vector<std::string>(patterns), threads);
+    }
+
+    /**
+     * @ingroup TextIO
+     * @brief Counts the lines of a file without materialising them.
+     *
+     * Newlines are counted with SIMD byte masks and popcount over 8 MB
+     * chunks read on worker threads. Matches readLines(): an unterminated
+     * last line counts, a trailing '\n' does not add an empty one.
+     *
+     * @param path    File to count
+     * @param threads Thread count; 0 uses all hardware threads
+     *
+     * @throws IOException if the file cannot be opened or read
+     *
+     * @note Compressed files are not supported.
+     */
+    inline uint64_t countLines(const std::string& path, unsigned threads = 0) {
+        struct ChunkCount {
+            uint64_t newlines = 0;
+            bool terminated = false; // chunk ends with '\n'
+        };
+        auto [size, counts] = detail::scanChunks<ChunkCount>(path, threads,
+            [](uint64_t, const char* data, size_t length) {
+                return ChunkCount{detail::countByte(data, length, '\n'), data[length - 1] == '\n'};
+            });
+        uint64_t lines = 0;
+        for (const auto& count : counts) lines += count.newlines;
+        return lines + (!counts.empty() && !counts.back().terminated);
+    }
+
+    /**
+     * @ingroup TextIO
+     * @struct FileStats
+     * @brief Summary of a text file returned by stats().
+     */
+    struct FileStats {
+        uint64_t lines = 0;       ///< Line count, as countLines() returns it
+        uint64_t bytes = 0;       ///< File size
+        uint64_t longestLine = 0; ///< Longest line in bytes, without its '\n' ('\r' included)
+    };
+
+    /**
+     * @ingroup TextIO
+     * @brief Counts lines and bytes and finds the longest line in one pass.
+     *
+     * Chunks are scanned in parallel; each reports its first and last
+     * newline and its longest inner line, and lines crossing chunk
+     * boundaries are stitched together afterwards.
+     *
+     * @param path    File to inspect
+     * @param threads Thread count; 0 uses all hardware threads
+     *
+     * @throws IOException if the file cannot be opened or read
+     *
+     * @note Compressed files are not supported.
+     */
+    inline FileStats stats(const std::string& path, unsigned threads = 0) {
+        struct ChunkStats {
+            uint64_t newlines = 0;
+            size_t first = 0;   // position of the first newline
+            size_t last = 0;    // position of the last newline
+            size_t longest = 0; // longest line between two newlines of the chunk
+            size_t length = 0;
+        };
+        auto [size, chunks] = detail::scanChunks<ChunkStats>(path, threads,
+            [](uint64_t, const char* data, size_t length) {
+                ChunkStats chunk;
+                chunk.length = length;
+                auto visit = [&chunk](size_t at) {
+                    if (chunk.newlines++ == 0) chunk.first = at;
+                    else chunk.longest = std::max(chunk.longest, at - chunk.last - 1);
+                    chunk.last = at;
+                };
+                size_t i = 0;
+                for (; i + 64 <= length; i += 64)
+                    for (uint64_t mask = detail::matchMask64(data + i, '\n'); mask; mask &= mask - 1)
+                        visit(i + static_cast<size_t>(std::countr_zero(mask)));
+                for (; i < length; ++i)
+                    if (data[i] == '\n') visit(i);
+                return chunk;
+            });
+
+        FileStats result;
+        result.bytes = size;
+        uint64_t open = 0; // length of the line still running into the next chunk
+        for (const auto& chunk : chunks) {
+            if (chunk.newlines == 0) {
+                open += chunk.length;
+                continue;
+            }
+            result.lines += chunk.newlines;
+            result.longestLine = std::max({result.longestLine, open + chunk.first, uint64_t(chunk.longest)});
+            open = chunk.length - chunk.last - 1;
         }
-        totalSize += missingNewlines;
+        result.longestLine = std::max(result.longestLine, open);
+        result.lines += open > 0;
+        return result;
+    }
 
-        // Allocate once and memcpy all data into the buffer to avoid per-line overhead
-        buffer.clear();
-        buffer.resize(totalSize);
-        char* ptr = buffer.data();
+    namespace detail {
+        /**
+         * @brief Tournament tree of losers over k sorted sources.
+         *
+         * Every inner node keeps the loser of its match and tree[0] the
+         * overall winner. After the winning source advances, replay() walks
+         * only its leaf-to-root path with one comparison per level, half of
+         * what sifting a binary heap costs. Ties go to the lower source.
+         */
+        template<typename Compare>
+        class LoserTree {
+        public:
+            LoserTree(size_t k, Compare& comparator) : heads(k), done(k, 0), tree(k), compare(comparator) {}
 
-        for (const auto &line : lines) {
-            size_t len = line.size();
-            if (len > 0) {
-                std::memcpy(ptr, line.data(), len);
-                ptr += len;
+            /**
+             * @brief Plays the initial tournament once every head is set.
+             */
+            void build() {
+                size_t k = heads.size();
+                std::vector<size_t> winners(2 * k);
+                for (size_t i = 0; i < k; ++i) winners[k + i] = i;
+                for (size_t node = k - 1; node >= 1; --node) {
+                    size_t a = winners[2 * node], b = winners[2 * node + 1];
+                    bool aWins = beats(a, b);
+                    winners[node] = aWins ? a : b;
+                    tree[node] = aWins ? b : a;
+                }
+                tree[0] = k > 1 ? winners[1] : 0;
+            }
+
+            /**
+             * @brief Restores the tree after heads[source] (or done[source]) changed.
+             */
+            void replay(size_t source) {
+                size_t winner = source;
+                for (size_t node = (source + heads.size()) / 2; node >= 1; node /= 2)
+                    if (beats(tree[node], winner)) std::swap(tree[node], winner);
+                tree[0] = winner;
+            }
+
+            size_t winner() const noexcept { return tree[0]; }
+
+            std::vector<std::string_view> heads; ///< Current line of each source
+            std::vector<char> done;              ///< Source is exhausted
+
+        private:
+            bool beats(size_t a, size_t b) const {
+                if (done[a]) return false;
+                if (done[b]) return true;
+                return a < b ? !compare(heads[b], heads[a]) : compare(heads[a], heads[b]);
+            }
+
+            std::vector<size_t> tree;
+            Compare& compare;
+        };
+
+        /**
+         * @brief Merges @p k sorted sources into @p out.
+         *
+         * advance(i, head) moves source i to its next line and returns false
+         * once it is exhausted; a head only needs to stay valid until the
+         * next call for the same source.
+         *
+         * @return Number of lines written
+         */
+        template<typename Compare, typename Advance>
+        inline uint64_t mergeSorted(size_t k, Compare& compare, Advance&& advance, TextWriter& out) {
+            if (k == 0) return 0;
+            LoserTree<Compare> tree(k, compare);
+            for (size_t i = 0; i < k; ++i) tree.done[i] = !advance(i, tree.heads[i]);
+            tree.build();
+
+            uint64_t lines = 0;
+            for (size_t winner = tree.winner(); !tree.done[winner]; winner = tree.winner()) {
+                out.writeLine(tree.heads[winner]);
+                ++lines;
+                tree.done[winner] = !advance(winner, tree.heads[winner]);
+                tree.replay(winner);
+            }
+            return lines;
+        }
+
+        /**
+         * @brief Most runs merged at once; more runs take several passes.
+         */
+        inline constexpr size_t MaxMergeFanIn = 512;
+
+        /**
+         * @brief Removes the temporary run files of an external sort.
+         */
+        struct SortRuns {
+            std::vector<std::string> paths;
+            std::string prefix;
+            size_t created = 0;
+
+            std::string next() { return prefix + std::to_string(created++) + ".tmp"; }
+
+            ~SortRuns() {
+                std::error_code ec;
+                for (const auto& path : paths) std::filesystem::remove(path, ec);
+            }
+        };
+    }
+
+    /**
+     * @ingroup TextIO
+     * @brief Sorts the lines of a file that may be much larger than memory.
+     *
+     * Lines are read with a TextReader into batches of about @p memoryBudget
+     * bytes. Each batch is cut into one slice per thread; the slices are
+     * sorted and written as runs in parallel. The runs are then merged
+     * through a loser tree with large sequential read buffers, in several
+     * passes if there are more than 512 runs or the budget cannot give
+     * every run a 4 KB buffer. Input that fits in one batch is merged
+     * straight from memory without temporary files.
+     *
+     * Run files are created next to @p output (`<output>.sort-N.tmp`) and
+     * removed when the sort finishes or fails.
+     *
+     * @param input        File to sort; compressed input is detected
+     * @param output       Destination; compressed by extension (.gz, .zst, .lz4).
+     *                     Every line, including the last, ends with '\n'.
+     * @param compare      Strict weak ordering on std::string_view lines
+     *                     (without '\n'); the default orders bytes as unsigned.
+     *                     Each sorting thread uses its own copy; the merge
+     *                     uses the original.
+     * @param memoryBudget Approximate memory for line data, line tables and
+     *                     merge buffers (at least 64 KB)
+     * @param threads      Thread count for sorting runs; 0 uses all hardware threads
+     * @return Number of lines written
+     *
+     * @throws std::invalid_argument if @p memoryBudget is below 64 KB
+     * @throws IOException if a file cannot be opened, read or written
+     *
+     * @note The sort is not stable.
+     */
+    template<typename Compare = std::less<>>
+    inline uint64_t externalSort(const std::string& input, const std::string& output, Compare compare = {},
+                                 size_t memoryBudget = 256 << 20, unsigned threads = 0) {
+        if (memoryBudget < 16 * MinBufferSize)
+            throw std::invalid_argument("External sort needs a memory budget of at least 64 KB.");
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+        // Each line costs its bytes, a start offset and a view while sorting
+        constexpr size_t LineOverhead = sizeof(size_t) + sizeof(std::string_view);
+        std::string arena;
+        std::vector<size_t> starts;
+        std::vector<std::string_view> lines;
+        std::error_code ec;
+        uint64_t inputSize = std::filesystem::file_size(input, ec);
+        arena.reserve(static_cast<size_t>(std::min<uint64_t>(memoryBudget, ec ? 0 : inputSize)));
+
+        // Sorts the batch in arena into slices, one per thread
+        auto sortBatch = [&] {
+            lines.clear();
+            lines.reserve(starts.size());
+            for (size_t i = 0; i < starts.size(); ++i) {
+                size_t end = i + 1 < starts.size() ? starts[i + 1] : arena.size();
+                lines.emplace_back(arena.data() + starts[i], end - starts[i]);
+            }
+            size_t slices = std::min<size_t>(threads, lines.size());
+            std::vector<std::span<std::string_view>> result(slices);
+            for (size_t s = 0; s < slices; ++s) {
+                size_t from = lines.size() * s / slices, to = lines.size() * (s + 1) / slices;
+                result[s] = std::span<std::string_view>(lines).subspan(from, to - from);
+            }
+            detail::parallelFor(slices, threads, [&](size_t s) {
+                Compare local = compare; // no comparator state is shared between threads
+                std::sort(result[s].begin(), result[s].end(), local);
+            });
+            return result;
+        };
+
+        size_t writeBuffer = std::clamp(memoryBudget / (4 * threads), MinBufferSize, DefaultBufferSize);
+        detail::SortRuns runs;
+        runs.prefix = output + ".sort-";
+        TextReader reader(input, DefaultBufferSize, Compression::Auto);
+        bool more = true;
+        std::string line;
+        while (more) {
+            arena.clear();
+            starts.clear();
+            while ((more = reader.readLine(line))) {
+                starts.push_back(arena.size());
+                arena += line;
+                if (arena.size() + starts.size() * LineOverhead >= memoryBudget) break;
+            }
+
+            auto slices = sortBatch();
+            if (!more && runs.paths.empty()) {
+                // Everything fit in one batch: merge the slices from memory
+                std::vector<size_t> positions(slices.size());
+                TextWriter out(output, false, DefaultBufferSize, Compression::Auto);
+                uint64_t written = detail::mergeSorted(slices.size(), compare, [&](size_t i, std::string_view& head) {
+                    if (positions[i] == slices[i].size()) return false;
+                    head = slices[i][positions[i]++];
+                    return true;
+                }, out);
+                out.close();
+                return written;
+            }
+
+            size_t first = runs.paths.size();
+            for (size_t s = 0; s < slices.size(); ++s) runs.paths.push_back(runs.next());
+            detail::parallelFor(slices.size(), threads, [&](size_t s) {
+                TextWriter run(runs.paths[first + s], false, writeBuffer);
+                for (std::string_view sorted : slices[s]) run.writeLine(sorted);
+                run.close();
+            });
+        }
+        arena = std::string();
+        starts = std::vector<size_t>();
+        lines = std::vector<std::string_view>();
+
+        // Merge passes: each pass combines groups of fanIn runs into one
+        size_t fanIn = std::clamp<size_t>(memoryBudget / MinBufferSize - 1, 2, detail::MaxMergeFanIn);
+        size_t readBuffer = std::max(MinBufferSize, memoryBudget / (fanIn + 1));
+        auto mergeRuns = [&](size_t from, size_t to, const std::string& target, Compression compression) {
+            std::vector<std::unique_ptr<TextReader>> sources;
+            std::vector<std::string> heads(to - from);
+            for (size_t i = from; i < to; ++i)
+                sources.push_back(std::make_unique<TextReader>(runs.paths[i], readBuffer));
+            TextWriter out(target, false, readBuffer, compression);
+            uint64_t written = detail::mergeSorted(sources.size(), compare, [&](size_t i, std::string_view& head) {
+                if (!sources[i]->readLine(heads[i])) return false;
+                head = heads[i];
+                return true;
+            }, out);
+            out.close();
+            return written;
+        };
+
+        size_t pending = 0; // runs before this index are merged and removed
+        while (runs.paths.size() - pending > fanIn) {
+            size_t end = runs.paths.size();
+            for (size_t from = pending; from < end; from += fanIn) {
+                size_t to = std::min(from + fanIn, end);
+                runs.paths.push_back(runs.next());
+                mergeRuns(from, to, runs.paths.back(), Compression::None);
+                for (size_t i = from; i < to; ++i) std::filesystem::remove(runs.paths[i], ec);
+            }
+            pending = end;
+        }
+        return mergeRuns(pending, runs.paths.size(), output, Compression::Auto);
+    }
+
+    namespace detail {
+        /**
+         * @brief Footer magic of the block container ("SFIOBLK1").
+         */
+        inline constexpr char BlockMagic[8] = {'S', 'F', 'I', 'O', 'B', 'L', 'K', '1'};
+
+        /**
+         * @brief Size of the block container footer: count, block size, codec, magic.
+         */
+        inline constexpr size_t BlockFooterSize = 24;
+
+        /**
+         * @brief Resolves Compression::Auto to the best block codec compiled in.
+         */
+        inline Compression blockCodec(Compression compression) noexcept {
+            if (compression != Compression::Auto) return compression;
+        #if defined(SFIO_HAVE_ZSTD)
+            return Compression::Zstd;
+        #elif defined(SFIO_HAVE_LZ4)
+            return Compression::Lz4;
+        #elif defined(SFIO_HAVE_ZLIB)
+            return Compression::Gzip;
+        #else
+            return Compression::None;
+        #endif
+        }
+
+        /**
+         * @brief True if blocks of this format can be encoded and decoded here.
+         */
+        inline bool blockCodecAvailable(Compression compression) noexcept {
+            switch (compression) {
+                case Compression::None: return true;
+            #if defined(SFIO_HAVE_ZLIB)
+                case Compression::Gzip: return true;
+            #endif
+            #if defined(SFIO_HAVE_ZSTD)
+                case Compression::Zstd: return true;
+            #endif
+            #if defined(SFIO_HAVE_LZ4)
+                case Compression::Lz4: return true;
+            #endif
+                default: return false;
+            }
+        }
+
+        /**
+         * @brief Worst-case encoded size of an @p n byte block.
+         */
+        inline size_t blockBound(Compression compression, size_t n) noexcept {
+            switch (compression) {
+            #if defined(SFIO_HAVE_ZLIB)
+                case Compression::Gzip: return compressBound(static_cast<uLong>(n));
+            #endif
+            #if defined(SFIO_HAVE_ZSTD)
+                case Compression::Zstd: return ZSTD_compressBound(n);
+            #endif
+            #if defined(SFIO_HAVE_LZ4)
+                case Compression::Lz4: return static_cast<size_t>(LZ4_compressBound(static_cast<int>(n)));
+            #endif
+                default: return n;
             }
-            if (len == 0 || line[len-1] != '\n') {
-                *ptr++ = '\n';
+        }
+
+        /**
+         * @brief Compresses one block into @p dst.
+         * @return Encoded size, or 0 if the block should be stored as is
+         *         (codec failure or no gain)
+         */
+        inline size_t encodeBlock(Compression compression, [[maybe_unused]] const char* src, size_t n,
+                                  [[maybe_unused]] char* dst, [[maybe_unused]] size_t capacity) noexcept {
+            size_t size = 0;
+            switch (compression) {
+            #if defined(SFIO_HAVE_ZLIB)
+                case Compression::Gzip: {
+                    uLongf length = static_cast<uLongf>(capacity);
+                    if (compress2(reinterpret_cast<Bytef*>(dst), &length, reinterpret_cast<const Bytef*>(src),
+                                  static_cast<uLong>(n), Z_DEFAULT_COMPRESSION) == Z_OK)
+                        size = length;
+                    break;
+                }
+            #endif
+            #if defined(SFIO_HAVE_ZSTD)
+                case Compression::Zstd: {
+                    size_t length = ZSTD_compress(dst, capacity, src, n, ZSTD_CLEVEL_DEFAULT);
+                    if (!ZSTD_isError(length)) size = length;
+                    break;
+                }
+            #endif
+            #if defined(SFIO_HAVE_LZ4)
+                case Compression::Lz4: {
+                    int length = LZ4_compress_default(src, dst, static_cast<int>(n), static_cast<int>(capacity));
+                    if (length > 0) size = static_cast<size_t>(length);
+                    break;
+                }
+            #endif
+                default:
+                    break;
             }
+            return size < n ? size : 0;
         }
 
-        size_t written = SFIO_FWRITE(buffer.data(), 1, buffer.size(), file);
-        if (written != buffer.size())
-            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write lines to file."), path);
+        /**
+         * @brief Decodes one block of exactly @p rawSize bytes.
+         *
+         * A block whose encoded size equals its raw size was stored as is.
+         */
+        inline bool decodeBlock(Compression compression, const char* src, size_t n,
+                                char* dst, size_t rawSize) noexcept {
+            if (n == rawSize) {
+                std::memcpy(dst, src, n);
+                return true;
+            }
+            switch (compression) {
+            #if defined(SFIO_HAVE_ZLIB)
+                case Compression::Gzip: {
+                    uLongf length = static_cast<uLongf>(rawSize);
+                    return uncompress(reinterpret_cast<Bytef*>(dst), &length, reinterpret_cast<const Bytef*>(src),
+                                      static_cast<uLong>(n)) == Z_OK && length == rawSize;
+                }
+            #endif
+            #if defined(SFIO_HAVE_ZSTD)
+                case Compression::Zstd: {
+                    size_t length = ZSTD_decompress(dst, rawSize, src, n);
+                    return !ZSTD_isError(length) && length == rawSize;
+                }
+            #endif
+            #if defined(SFIO_HAVE_LZ4)
+                case Compression::Lz4:
+                    return LZ4_decompress_safe(src, dst, static_cast<int>(n), static_cast<int>(rawSize))
+                        == static_cast<int>(rawSize);
+            #endif
+                default:
+                    return false;
+            }
+        }
     }
 
     /**
      * @ingroup BinaryIO
-     * @class ByteReader
-     * @brief High-performance binary file reader.
+     * @class BasicBlockWriter
+     * @brief Writes a seekable, block-compressed container.
      *
-     * Provides efficient sequential access to raw bytes using a manually
-     * managed 1 MB buffer to minimize system call overhead.
+     * Data is cut into blocks of a fixed uncompressed size, each compressed
+     * independently (blocks that do not shrink are stored as is). close()
+     * appends an index of per-block sizes and a footer, which lets
+     * BasicBlockReader decode blocks in parallel and seek by uncompressed
+     * offset.
      *
-     * @note Intended for large, contiguous binary reads.
-     * @warning Not safe for concurrent access from multiple threads.
+     * Layout: block data, then 8 bytes per block (encoded size, raw size;
+     * 32-bit little-endian each), then a 24-byte footer (block count,
+     * block size, codec, "SFIOBLK1").
+     *
+     * @tparam Allocator Allocator for the pooled buffers (see BasicBufferPool)
      */
-    class ByteReader {
+    template<typename Allocator = std::allocator<char>>
+    class BasicBlockWriter {
     public:
         /**
-         * @brief Opens a binary file for reading.
+         * @brief Creates (or truncates) a block container.
          *
-         * @param path Path to the file
-         *
-         * @throws IOException if the file cannot be opened
-         *         (e.g., file does not exist or permission is denied)
+         * @param path        Path to the file
+         * @param compression Block codec; Compression::Auto picks the best one
+         *                    compiled in (zstd, lz4, then gzip), falling back
+         *                    to Compression::None (stored blocks)
+         * @param blockSize   Uncompressed size of each block (at most 1 GB)
          *
-         * @note The file is opened in binary mode ("rb").
+         * @throws IOException if the file cannot be opened or the codec is
+         *         not available in this build
+         * @throws std::invalid_argument if blockSize is 0 or above 1 GB
          */
-        inline ByteReader(const std::string& path);
+        inline BasicBlockWriter(const std::string& path, Compression compression = Compression::Auto,
+                                size_t blockSize = DefaultBufferSize);
 
         /**
-         * @brief Closes the file and releases all associated resources.
-         *
-         * @note Automatically closes the underlying FILE handle.
+         * @brief Closes the container; errors are ignored (call close() to observe them).
          */
-        inline ~ByteReader();
+        inline ~BasicBlockWriter();
 
         /**
          * @brief Checks whether a file exists.
+         */
+        inline static bool exists(const std::string& path);
+
+        /**
+         * @brief Appends raw bytes.
          *
-         * @param path Path to the file
-         * @return True if the file exists, false otherwise
+         * @complexity Time: O(n)
          *
-         * @note This function does not verify read permissions.
+         * @throws IOException on write failure
          */
-        inline static bool exists(const std::string& path);
+        inline void write(std::span<const char> data);
 
         /**
-         * @brief Reads the entire file into a byte buffer.
+         * @brief Appends raw bytes.
          *
-         * @return Vector containing all bytes read from the file
+         * @throws IOException on write failure
+         */
+        inline void writeBytes(const std::vector<char>& data);
+
+        /**
+         * @brief Ends the current block early and writes it out.
          *
-         * @throws IOException on low-level read failure
+         * @throws IOException on write failure
+         */
+        inline void flush();
+
+        /**
+         * @brief Writes the last block, the index and the footer.
          *
-         * @complexity Time: O(n)  
-         * @complexity Space: O(n)
+         * The writer cannot be used afterwards.
          *
-         * @note The returned vector grows dynamically as needed.
-         * @warning Large files will be fully loaded into memory.
+         * @throws IOException on write failure
          */
-        inline std::vector<char> readBytes();
+        inline void close();
 
     private:
-        FILE* file = nullptr;
+        inline bool emitBlock() noexcept;
+
+        detail::FileHandle file;
         std::string path;
-        std::vector<char> buffer; // per-file 1MB buffer
+        Compression codec;
+        size_t blockSize;
+        typename BasicBufferPool<Allocator>::Buffer block;  // pending uncompressed block
+        typename BasicBufferPool<Allocator>::Buffer packed; // encoded block
+        size_t used = 0;            // bytes pending in block
+        std::vector<char> index;    // 8 bytes per written block
     };
 
-    inline ByteReader::ByteReader(const std::string& p)
-        : path(p)
+    /**
+     * @ingroup BinaryIO
+     * @brief BlockWriter using the standard allocator.
+     */
+    using BlockWriter = BasicBlockWriter<>;
+
+    template<typename Allocator>
+    inline BasicBlockWriter<Allocator>::BasicBlockWriter(const std::string& p, Compression compression, size_t size)
+        : path(p), codec(detail::blockCodec(compression)), blockSize(size)
     {
-        file = std::fopen(path.c_str(), "rb");
+        if (blockSize == 0 || blockSize > (size_t(1) << 30))
+            throw std::invalid_argument("Block size must be between 1 byte and 1 GB.");
+
+        file = detail::FileHandle::open(path, detail::OpenMode::Write, true);
         if (!file)
             throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+        if (!detail::blockCodecAvailable(codec))
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Compression format not available in this build."), path);
 
-        // Allocate per-file 1 MB buffer for manual reads
-        buffer.resize(1 << 20);
-        // Do not use setvbuf() with our buffer here to avoid buffer aliasing with fread() calls
+        block = BasicBufferPool<Allocator>::local().acquire(blockSize);
+        packed = BasicBufferPool<Allocator>::local().acquire(detail::blockBound(codec, blockSize));
     }
 
-    inline ByteReader::~ByteReader() {
+    template<typename Allocator>
+    inline BasicBlockWriter<Allocator>::~BasicBlockWriter() {
         if (!file) return;
-        std::fclose(file);
+        try { close(); } catch (...) {} // errors are ignored here; call close() to observe them
     }
 
-    inline bool ByteReader::exists(const std::string& path) {
+    template<typename Allocator>
+    inline bool BasicBlockWriter<Allocator>::exists(const std::string& path) {
         return std::filesystem::exists(path);
     }
 
-    inline std::vector<char> ByteReader::readBytes() {
-        std::vector<char> data;
-        data.reserve(4 << 20); // start with 4 MB, grows dynamically if needed
+    template<typename Allocator>
+    inline bool BasicBlockWriter<Allocator>::emitBlock() noexcept {
+        if (used == 0) return true;
+        size_t raw = std::exchange(used, 0);
+        size_t encoded = detail::encodeBlock(codec, block.data(), raw, packed.data(), packed.size());
 
-        while (true) {
-            size_t bytesRead = SFIO_FREAD(buffer.data(), 1, buffer.size(), file);
-            if (bytesRead == 0) {
-                if (ferror(file))
-                    throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
-                break;
-            }
-            data.insert(data.end(), buffer.data(), buffer.data() + bytesRead);
+        char entry[8];
+        detail::storeLE(entry, encoded ? encoded : raw, 4);
+        detail::storeLE(entry + 4, raw, 4);
+        index.insert(index.end(), entry, entry + 8);
+
+        return encoded ? file.write(packed.data(), encoded) : file.write(block.data(), raw);
+    }
+
+    template<typename Allocator>
+    inline void BasicBlockWriter<Allocator>::write(std::span<const char> data) {
+        if (!file)
+            throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
+
+        while (!data.empty()) {
+            size_t take = std::min(data.size(), blockSize - used);
+            std::memcpy(block.data() + used, data.data(), take);
+            used += take;
+            data = data.subspan(take);
+            if (used == blockSize && !emitBlock())
+                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write block."), path);
         }
+    }
 
-        return data;
+    template<typename Allocator>
+    inline void BasicBlockWriter<Allocator>::writeBytes(const std::vector<char>& data) {
+        write(std::span<const char>(data.data(), data.size()));
+    }
+
+    template<typename Allocator>
+    inline void BasicBlockWriter<Allocator>::flush() {
+        if (!file) return;
+        if (!emitBlock() || !file.flush())
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to flush file."), path);
+    }
+
+    template<typename Allocator>
+    inline void BasicBlockWriter<Allocator>::close() {
+        if (!file) return;
+
+        bool ok = emitBlock();
+
+        char footer[detail::BlockFooterSize] = {};
+        detail::storeLE(footer, index.size() / 8, 8);
+        detail::storeLE(footer + 8, blockSize, 4);
+        footer[12] = static_cast<char>(codec);
+        std::memcpy(footer + 16, detail::BlockMagic, sizeof(detail::BlockMagic));
+
+        ok = ok
+            && file.write(index.data(), index.size())
+            && file.write(footer, sizeof(footer));
+        file.close();
+        if (!ok)
+            throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write block index."), path);
     }
 
     /**
      * @ingroup BinaryIO
-     * @class ByteWriter
-     * @brief High-performance binary file writer.
+     * @class BasicBlockReader
+     * @brief Reads containers written by BasicBlockWriter.
      *
-     * Writes raw byte buffers efficiently using chunked I/O to avoid
-     * excessive memory usage and system calls.
+     * The index is loaded on open, so any uncompressed offset maps to a
+     * block with a binary search. Sequential and positional reads decode
+     * one block at a time into a pooled buffer; readBytes() and
+     * forEachBlock() decode blocks across worker threads.
      *
-     * @note Uses chunked writes for large buffers.
-     * @warning Not safe for concurrent access from multiple threads.
+     * @tparam Allocator Allocator for the pooled buffers (see BasicBufferPool)
+     *
+     * @note Parallel decoding relies on pread; with SFIO_USE_STDIO it runs
+     *       on the calling thread only.
      */
-    class ByteWriter {
+    template<typename Allocator = std::allocator<char>>
+    class BasicBlockReader {
     public:
         /**
-         * @brief Opens a binary file for writing.
+         * @brief Opens a block container and loads its index.
          *
-         * @param path   Path to the file
-         * @param append If true, appends to the file instead of overwriting
-         *
-         * @throws IOException if the file cannot be opened
-         *
-         * @note The file is opened in binary mode ("wb" or "ab").
+         * @throws IOException if the file cannot be opened, is not a block
+         *         container, or uses a codec not available in this build
          */
-        inline ByteWriter(const std::string& path, bool append = false);
+        inline explicit BasicBlockReader(const std::string& path);
 
         /**
-         * @brief Flushes buffered output and closes the file.
-         *
-         * @note Destructor ensures that all pending data is flushed to disk.
+         * @brief Checks whether a file exists.
+         */
+        inline static bool exists(const std::string& path);
+
+        /**
+         * @brief Total uncompressed size.
          */
-        inline ~ByteWriter();
+        uint64_t size() const noexcept { return rawOffsets.back(); }
 
         /**
-         * @brief Checks whether a file exists.
+         * @brief Number of blocks in the container.
+         */
+        size_t blockCount() const noexcept { return rawOffsets.size() - 1; }
+
+        /**
+         * @brief Reads up to dst.size() bytes from the current position.
          *
-         * @param path Path to the file
-         * @return True if the file exists, false otherwise
+         * @return Bytes read; 0 at the end of the data
+         *
+         * @throws IOException on read failure or corrupt blocks
          */
-        inline static bool exists(const std::string& path);
+        inline size_t read(std::span<char> dst);
 
         /**
-         * @brief Flushes any buffered output to disk.
+         * @brief Reads up to dst.size() bytes at an uncompressed offset.
          *
-         * @throws IOException on flush failure
+         * Does not move the sequential read position.
          *
-         * @note This does not close the file.
+         * @complexity O(log b) to locate the block plus one block decode
+         *
+         * @throws IOException on read failure or corrupt blocks
          */
-        inline void flush();
+        inline size_t readAt(uint64_t offset, std::span<char> dst);
 
         /**
-         * @brief Writes a byte buffer to the file.
+         * @brief Moves the sequential read position (may point past the end).
+         */
+        void seek(uint64_t offset) noexcept { position = offset; }
+
+        /**
+         * @brief Current sequential read position.
+         */
+        uint64_t tell() const noexcept { return position; }
+
+        /**
+         * @brief Decodes the whole container across worker threads.
          *
-         * Performs chunked writes to safely handle very large buffers.
+         * @param threads Thread count; 0 uses all hardware threads
          *
-         * @param data Byte buffer to write
+         * @throws IOException on read failure or corrupt blocks
+         */
+        inline std::vector<char> readBytes(unsigned threads = 0);
+
+        /**
+         * @brief Decodes every block across worker threads and hands it to @p fn.
          *
-         * @throws IOException on write failure
+         * fn(uint64_t offset, std::string_view data) is called concurrently
+         * and in no particular order; @p data is only valid during the call.
          *
-         * @complexity Time: O(n)  
-         * @complexity Space: O(1)
+         * @param threads Thread count; 0 uses all hardware threads
          *
-         * @warning Partial writes result in an exception; no retry is attempted.
+         * @throws IOException on read failure or corrupt blocks, or whatever
+         *         @p fn throws
          */
-        inline void writeBytes(const std::vector<char>& data);
+        template<typename Fn>
+        inline void forEachBlock(Fn&& fn, unsigned threads = 0);
 
     private:
-        FILE* file = nullptr;
+        inline void decode(size_t block, char* dst, char* scratch);
+        inline void load(size_t block);
+
+        detail::FileHandle file;
         std::string path;
-        bool append = false;
-        std::vector<char> buffer; // per-file 1MB buffer
+        Compression codec = Compression::None;
+        size_t blockSize = 0;
+        std::vector<uint64_t> rawOffsets{0};  // uncompressed start of each block, plus total
+        std::vector<uint64_t> fileOffsets{0}; // encoded start of each block, plus index start
+        typename BasicBufferPool<Allocator>::Buffer block;  // decoded block cache
+        typename BasicBufferPool<Allocator>::Buffer packed; // encoded block
+        size_t cached = std::numeric_limits<size_t>::max();
+        uint64_t position = 0;
     };
 
-    inline ByteWriter::ByteWriter(const std::string& p, bool a)
-        : path(p), append(a)
+    /**
+     * @ingroup BinaryIO
+     * @brief BlockReader using the standard allocator.
+     */
+    using BlockReader = BasicBlockReader<>;
+
+    template<typename Allocator>
+    inline BasicBlockReader<Allocator>::BasicBlockReader(const std::string& p)
+        : path(p)
     {
-        const char* modeStr = append ? "ab" : "wb";
-        file = std::fopen(path.c_str(), modeStr);
+        file = detail::FileHandle::open(path, detail::OpenMode::Read, true);
         if (!file)
             throw IOException(IOError::FileNotOpen, formatIOError(IOError::FileNotOpen, path), path);
 
-        // Allocate per-file 1 MB buffer for assembling write payloads
-        buffer.resize(1 << 20);
-        // Do NOT pass this buffer to setvbuf(). Using the same memory for stdio's
-        // internal buffer and as the write source can cause corrupted output when reused.
-    }
+        auto invalid = [this] {
+            return IOException(IOError::ReadError, formatIOError(IOError::ReadError, path, "Not a valid block container."), path);
+        };
+        // Short reads are retried; only an early EOF means a damaged container
+        auto readFully = [&](char* dst, size_t n, uint64_t offset) {
+            ptrdiff_t got = detail::preadFull(file, dst, n, offset);
+            if (got < 0)
+                throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+            return got == static_cast<ptrdiff_t>(n);
+        };
 
-    inline ByteWriter::~ByteWriter() {
-        if (!file) return;
-        std::fflush(file);
-        std::fclose(file);
+        std::error_code ec;
+        uint64_t fileSize = std::filesystem::file_size(path, ec);
+        char footer[detail::BlockFooterSize];
+        if (ec || fileSize < sizeof(footer)
+            || !readFully(footer, sizeof(footer), fileSize - sizeof(footer))
+            || std::memcmp(footer + 16, detail::BlockMagic, sizeof(detail::BlockMagic)) != 0)
+            throw invalid();
+
+        uint64_t count = detail::loadLE(footer, 8);
+        blockSize = static_cast<size_t>(detail::loadLE(footer + 8, 4));
+        codec = static_cast<Compression>(static_cast<unsigned char>(footer[12]));
+        if (count > (fileSize - sizeof(footer)) / 8 || blockSize == 0)
+            throw invalid();
+        if (!detail::blockCodecAvailable(codec))
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path, "Compression format not available in this build."), path);
+
+        std::vector<char> entries(static_cast<size_t>(count) * 8);
+        uint64_t indexStart = fileSize - sizeof(footer) - entries.size();
+        if (!entries.empty() && !readFully(entries.data(), entries.size(), indexStart))
+            throw invalid();
+
+        rawOffsets.reserve(count + 1);
+        fileOffsets.reserve(count + 1);
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t encoded = detail::loadLE(entries.data() + 8 * i, 4);
+            uint64_t raw = detail::loadLE(entries.data() + 8 * i + 4, 4);
+            if (raw > blockSize || encoded > detail::blockBound(codec, blockSize))
+                throw invalid();
+            rawOffsets.push_back(rawOffsets.back() + raw);
+            fileOffsets.push_back(fileOffsets.back() + encoded);
+        }
+        if (fileOffsets.back() != indexStart)
+            throw invalid();
+
+        block = BasicBufferPool<Allocator>::local().acquire(blockSize);
+        packed = BasicBufferPool<Allocator>::local().acquire(detail::blockBound(codec, blockSize));
     }
 
-    inline bool ByteWriter::exists(const std::string& path) {
+    template<typename Allocator>
+    inline bool BasicBlockReader<Allocator>::exists(const std::string& path) {
         return std::filesystem::exists(path);
     }
 
-    inline void ByteWriter::flush() {
-        if (!file) return;
-        std::fflush(file);
+    template<typename Allocator>
+    inline void BasicBlockReader<Allocator>::decode(size_t index, char* dst, char* scratch) {
+        size_t encoded = static_cast<size_t>(fileOffsets[index + 1] - fileOffsets[index]);
+        size_t raw = static_cast<size_t>(rawOffsets[index + 1] - rawOffsets[index]);
+        ptrdiff_t got = detail::preadFull(file, scratch, encoded, fileOffsets[index]);
+        if (got < 0)
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path), path);
+        if (got != static_cast<ptrdiff_t>(encoded)) // file shrank since it was opened
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path, "Corrupt block."), path);
+        if (!detail::decodeBlock(codec, scratch, encoded, dst, raw))
+            throw IOException(IOError::ReadError, formatIOError(IOError::ReadError, path, "Corrupt block."), path);
+    }
+
+    template<typename Allocator>
+    inline void BasicBlockReader<Allocator>::load(size_t index) {
+        if (cached == index) return;
+        cached = std::numeric_limits<size_t>::max(); // stays invalid if decoding fails
+        decode(index, block.data(), packed.data());
+        cached = index;
     }
 
-    inline void ByteWriter::writeBytes(const std::vector<char>& data) {
-        const size_t chunkSize = 1 << 20; // 1 MB
-        size_t offset = 0;
-        while (offset < data.size()) {
-            size_t toWrite = std::min(chunkSize, data.size() - offset);
-            size_t written = SFIO_FWRITE(data.data() + offset, 1, toWrite, file);
-            if (written != toWrite)
-                throw IOException(IOError::WriteError, formatIOError(IOError::WriteError, path, "Failed to write bytes to file."), path);
-            offset += written;
+    template<typename Allocator>
+    inline size_t BasicBlockReader<Allocator>::readAt(uint64_t offset, std::span<char> dst) {
+        size_t total = 0;
+        while (total < dst.size() && offset < size()) {
+            // Block containing offset: last block starting at or before it
+            size_t index = static_cast<size_t>(
+                std::upper_bound(rawOffsets.begin(), rawOffsets.end(), offset) - rawOffsets.begin() - 1);
+            load(index);
+            size_t within = static_cast<size_t>(offset - rawOffsets[index]);
+            size_t available = static_cast<size_t>(rawOffsets[index + 1] - offset);
+            size_t take = std::min(available, dst.size() - total);
+            std::memcpy(dst.data() + total, block.data() + within, take);
+            total += take;
+            offset += take;
         }
+        return total;
+    }
+
+    template<typename Allocator>
+    inline size_t BasicBlockReader<Allocator>::read(std::span<char> dst) {
+        size_t got = readAt(position, dst);
+        position += got;
+        return got;
+    }
+
+    template<typename Allocator>
+    inline std::vector<char> BasicBlockReader<Allocator>::readBytes(unsigned threads) {
+        std::vector<char> data(static_cast<size_t>(size()));
+        size_t bound = detail::blockBound(codec, blockSize);
+        detail::parallelFor(blockCount(), detail::preadThreads(threads), [&](size_t index) {
+            // Each worker thread recycles scratch blocks through its own pool
+            auto scratch = BasicBufferPool<Allocator>::local().acquire(bound);
+            decode(index, data.data() + rawOffsets[index], scratch.data());
+        });
+        return data;
+    }
+
+    template<typename Allocator>
+    template<typename Fn>
+    inline void BasicBlockReader<Allocator>::forEachBlock(Fn&& fn, unsigned threads) {
+        size_t bound = detail::blockBound(codec, blockSize);
+        detail::parallelFor(blockCount(), detail::preadThreads(threads), [&](size_t index) {
+            auto& pool = BasicBufferPool<Allocator>::local();
+            auto scratch = pool.acquire(bound);
+            auto decoded = pool.acquire(blockSize);
+            decode(index, decoded.data(), scratch.data());
+            fn(rawOffsets[index], std::string_view(decoded.data(),
+                                                   static_cast<size_t>(rawOffsets[index + 1] - rawOffsets[index])));
+        });
     }
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #include "SimpleFileIO.hpp"
 #include <catch2/catch_test_macros.hpp>
 #include <filesystem>
+#include <numeric>
 
 using namespace SimpleFileIO;
 namespace fs = std::filesystem;
@@ -128,4 +129,1130 @@ TEST_CASE("Reader on missing file throws", "[File]") {
     } catch (const IOException& e) {
         REQUIRE(e.code == IOError::FileNotFound);
     }
+
+    try {
+        ByteReader fRead(textFile);
+        FAIL("Expected IOException for FileNotFound");
+    } catch (const IOException& e) {
+        REQUIRE(e.code == IOError::FileNotFound);
+    }
+}
+
+TEST_CASE("Buffer pool recycles buffers", "[Core]") {
+    const char* first = nullptr;
+    {
+        auto buf = BufferPool::local().acquire(100);
+        REQUIRE(buf.size() == MinBufferSize);
+        first = buf.data();
+    }
+    auto again = BufferPool::local().acquire(MinBufferSize);
+    REQUIRE(again.data() == first);
+}
+
+TEST_CASE("Lines larger than a small buffer round-trip (text)", "[File][Text]") {
+    removeFile(textFile);
+
+    std::vector<std::string> lines = {std::string(10000, 'a'), "", "short", std::string(5000, 'b')};
+
+    {
+        TextWriter fWrite(textFile, false, MinBufferSize);
+        fWrite.writeLines(lines);
+        fWrite.writeLine(std::string(9000, 'c'));
+    }
+
+    {
+        TextReader fRead(textFile, MinBufferSize);
+        auto expected = lines;
+        expected.push_back(std::string(9000, 'c'));
+        REQUIRE(fRead.readLines() == expected);
+    }
+}
+
+namespace {
+    inline size_t countingAllocations = 0;
+    inline size_t largestAllocation = 0;
+
+    template<typename T>
+    struct CountingAllocator {
+        using value_type = T;
+        CountingAllocator() = default;
+        template<typename U> CountingAllocator(const CountingAllocator<U>&) {}
+        T* allocate(size_t n) {
+            ++countingAllocations;
+            largestAllocation = std::max(largestAllocation, n * sizeof(T));
+            return std::allocator<T>{}.allocate(n);
+        }
+        void deallocate(T* p, size_t n) { std::allocator<T>{}.deallocate(p, n); }
+        bool operator==(const CountingAllocator&) const = default;
+    };
+}
+
+TEST_CASE("Custom allocator and buffer size (text)", "[File][Text]") {
+    removeFile(textFile);
+
+    {
+        BasicTextWriter<CountingAllocator<char>> fWrite(textFile, false, 8 << 20);
+        fWrite.writeLine("allocated");
+    }
+    REQUIRE(countingAllocations == 1);
+
+    {
+        BasicTextReader<CountingAllocator<char>> fRead(textFile);
+        REQUIRE(fRead.readLine() == "allocated");
+    }
+    REQUIRE(countingAllocations == 2);
+}
+
+TEST_CASE("Buffers released on another thread are not recycled there", "[Core]") {
+    using Pool = BasicBufferPool<CountingAllocator<char>>;
+    auto buf = Pool::local().acquire(1 << 20);
+
+    size_t before = countingAllocations;
+    std::thread([&] {
+        { auto foreign = std::move(buf); } // freed, not cached in this thread's pool
+        auto fresh = Pool::local().acquire(1 << 20);
+    }).join();
+    REQUIRE(countingAllocations == before + 1);
+}
+
+TEST_CASE("Huge-page and NUMA-local buffers (binary)", "[File][Binary]") {
+    removeFile(binaryFile);
+
+    std::vector<char> data(100000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = char(i * 31);
+
+    {
+        BasicByteWriter<HugePageAllocator<char>> fWrite(binaryFile);
+        fWrite.writeBytes(data);
+    }
+
+    {
+        BasicByteReader<NumaLocalAllocator<char>> fRead(binaryFile, 16 << 10);
+        REQUIRE(fRead.readBytes() == data);
+    }
+
+    // Small pool classes stay on normal pages instead of a 2 MB huge page each
+    REQUIRE(detail::mappedSize(MinBufferSize, MapHugePages) == MinBufferSize);
+    REQUIRE(detail::mappedSize(64 << 10, MapHugePages | MapNumaLocal) == 64 << 10);
+    REQUIRE(detail::mappedSize(3 << 20, MapHugePages) == 4 << 20);
+    REQUIRE(detail::mappedSize(3 << 20, MapDefault) == 3 << 20);
+}
+
+TEST_CASE("Buffered writes reach the file on flush (text)", "[File][Text]") {
+    removeFile(textFile);
+
+    TextWriter fWrite(textFile, false, MinBufferSize);
+    fWrite.writeString("a");
+    fWrite.writeLine("b");
+    fWrite.writeString(std::string(MinBufferSize * 2, 'c'));
+    fWrite.writeLine("d");
+    fWrite.flush();
+
+    TextReader fRead(textFile);
+    REQUIRE(fRead.readString() == "ab\n" + std::string(MinBufferSize * 2, 'c') + "d\n");
+}
+
+TEST_CASE("Stream file range to a descriptor (binary)", "[File][Binary]") {
+    removeFile(binaryFile);
+
+    std::vector<char> data(300000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = char(i * 7);
+    {
+        ByteWriter fWrite(binaryFile);
+        fWrite.writeBytes(data);
+    }
+
+    const std::string copyFile = "binary_copy.bin";
+    removeFile(copyFile);
+    {
+        ByteReader fRead(binaryFile);
+        FILE* out = std::fopen(copyFile.c_str(), "wb");
+        REQUIRE(out);
+        REQUIRE(fRead.streamTo(fileno(out), 1000, 200000) == 200000);
+        REQUIRE(fRead.streamTo(fileno(out), 290000) == 10000);
+        std::fclose(out);
+    }
+
+    ByteReader fCopy(copyFile);
+    std::vector<char> expected(data.begin() + 1000, data.begin() + 201000);
+    expected.insert(expected.end(), data.begin() + 290000, data.end());
+    REQUIRE(fCopy.readBytes() == expected);
+    removeFile(copyFile);
+}
+
+TEST_CASE("Non-throwing API reports EOF and errors as values", "[File][Text][Binary]") {
+    removeFile(textFile);
+
+    {
+        TextWriter fWrite(textFile);
+        REQUIRE(fWrite.tryWrite("first\n\nlast"));
+    }
+
+    {
+        TextReader fRead(textFile);
+        REQUIRE(fRead.tryReadLine().value() == "first");
+        REQUIRE(fRead.tryReadLine().value() == "");
+        REQUIRE(fRead.tryReadLine().value() == "last");
+        auto eof = fRead.tryReadLine();
+        REQUIRE_FALSE(eof);
+        REQUIRE(eof.error() == IOError::EndOfFile);
+    }
+
+    removeFile(binaryFile);
+    {
+        ByteWriter fWrite(binaryFile);
+        const char bytes[] = {1, 2, 3, 4, 5};
+        REQUIRE(fWrite.tryWrite(std::span<const char>(bytes, 5)));
+    }
+
+    {
+        ByteReader fRead(binaryFile);
+        char chunk[3];
+        REQUIRE(fRead.tryRead(chunk).value() == 3);
+        REQUIRE(chunk[2] == 3);
+        REQUIRE(fRead.tryRead(chunk).value() == 2);
+        REQUIRE(chunk[1] == 5);
+        REQUIRE(fRead.tryRead(chunk).error() == IOError::EndOfFile);
+        REQUIRE(fRead.read(chunk) == 0);
+    }
+}
+
+TEST_CASE("Empty lines are not mistaken for EOF (text)", "[File][Text]") {
+    removeFile(textFile);
+
+    {
+        TextWriter fWrite(textFile);
+        fWrite.writeString("a\n\n\nb\n\n");
+    }
+
+    {
+        TextReader fRead(textFile);
+        std::vector<std::string> expected = {"a", "", "", "b", ""};
+        REQUIRE(fRead.readLines() == expected);
+    }
+
+    {
+        TextReader fRead(textFile);
+        std::string line;
+        REQUIRE(fRead.readLine(line));
+        REQUIRE(line == "a");
+        REQUIRE(fRead.readLine(line));
+        REQUIRE(line.empty());
+        REQUIRE(fRead.readLines(2) == std::vector<std::string>{"", "b"});
+        REQUIRE(fRead.readLine(line));
+        REQUIRE(line.empty());
+        REQUIRE_FALSE(fRead.readLine(line));
+    }
+}
+
+TEST_CASE("Custom delimiters and CRLF stripping (text)", "[File][Text]") {
+    removeFile(textFile);
+
+    {
+        TextWriter fWrite(textFile);
+        fWrite.writeString("one\r\ntwo\n\r\nthree\r\n");
+    }
+
+    {
+        TextReader fRead(textFile);
+        fRead.setStripCR(true);
+        std::vector<std::string> expected = {"one", "two", "", "three"};
+        REQUIRE(fRead.readLines() == expected);
+    }
+
+    removeFile(textFile);
+    std::string record(3000, 'x');
+    {
+        TextWriter fWrite(textFile);
+        for (int i = 0; i < 10; ++i) fWrite.writeString(record + "||");
+        fWrite.writeString("tail|");
+    }
+
+    {
+        // Small buffer so the separator straddles buffer refills
+        TextReader fRead(textFile, MinBufferSize);
+        fRead.setDelimiter("||");
+        auto lines = fRead.readLines();
+        REQUIRE(lines.size() == 11);
+        REQUIRE(lines[0] == record);
+        REQUIRE(lines[9] == record);
+        REQUIRE(lines[10] == "tail|");
+    }
+
+    {
+        TextReader fRead(textFile);
+        fRead.setDelimiter('|');
+        REQUIRE(fRead.readLine() == record);
+        REQUIRE(fRead.readLine().empty());
+        REQUIRE(fRead.readLine() == record);
+    }
+}
+
+TEST_CASE("CSV rows with quotes, escapes and embedded newlines", "[File][Text][Csv]") {
+    removeFile(textFile);
+
+    {
+        TextWriter fWrite(textFile);
+        fWrite.writeString("id,name,note\r\n"
+                           "1,\"Smith, J\",\"said \"\"hi\"\"\"\n"
+                           "2,,\"multi\nline\"\n"
+                           "3,last,");
+    }
+
+    CsvReader csv(textFile);
+    std::span<const std::string_view> row;
+
+    REQUIRE(csv.readRow(row));
+    REQUIRE(std::vector<std::string_view>(row.begin(), row.end()) == std::vector<std::string_view>{"id", "name", "note"});
+    REQUIRE(csv.readRow(row));
+    REQUIRE(std::vector<std::string_view>(row.begin(), row.end()) == std::vector<std::string_view>{"1", "Smith, J", "said \"hi\""});
+    REQUIRE(csv.readRow(row));
+    REQUIRE(std::vector<std::string_view>(row.begin(), row.end()) == std::vector<std::string_view>{"2", "", "multi\nline"});
+    REQUIRE(csv.readRow(row));
+    REQUIRE(std::vector<std::string_view>(row.begin(), row.end()) == std::vector<std::string_view>{"3", "last", ""});
+    REQUIRE_FALSE(csv.readRow(row));
+
+    // A quoted field left open at EOF is malformed, not a short row
+    {
+        TextWriter fWrite(textFile);
+        fWrite.writeString("a,b\n1,\"unterminated\nstill open");
+    }
+    CsvReader truncated(textFile);
+    REQUIRE(truncated.readRow(row));
+    REQUIRE_THROWS_AS(truncated.readRow(row), IOException);
+}
+
+TEST_CASE("TSV rows spanning buffer refills", "[File][Text][Csv]") {
+    removeFile(textFile);
+
+    std::string longField(6000, 'z');
+    {
+        TextWriter fWrite(textFile);
+        for (int i = 0; i < 50; ++i)
+            fWrite.writeLine(std::to_string(i) + "\t\"" + longField + "\t\n\"\t" + std::to_string(i * 2));
+    }
+
+    BasicCsvReader<> tsv(textFile, '\t', '"', MinBufferSize);
+    std::span<const std::string_view> row;
+    int rows = 0;
+    while (tsv.readRow(row)) {
+        REQUIRE(row.size() == 3);
+        REQUIRE(row[0] == std::to_string(rows));
+        REQUIRE(row[1] == longField + "\t\n");
+        REQUIRE(row[2] == std::to_string(rows * 2));
+        ++rows;
+    }
+    REQUIRE(rows == 50);
+}
+
+TEST_CASE("Numeric parsing straight from the read buffer", "[File][Text]") {
+    removeFile(textFile);
+
+    {
+        TextWriter fWrite(textFile);
+        fWrite.writeString("12345678901, -42 +7\n0.5,-1e3\t2.25\n\n");
+        for (int i = 0; i < 2000; ++i)
+            fWrite.writeLine(std::to_string(i) + " " + std::to_string(i * 0.5) + " name" + std::to_string(i) + " ignored");
+    }
+
+    TextReader fRead(textFile, MinBufferSize);
+    int64_t i = 0;
+    double d = 0;
+    REQUIRE(fRead.readInt64(i));
+    REQUIRE(i == 12345678901);
+    REQUIRE(fRead.readInt64(i));
+    REQUIRE(i == -42);
+    REQUIRE(fRead.readInt64(i));
+    REQUIRE(i == 7);
+    REQUIRE(fRead.readDouble(d));
+    REQUIRE(d == 0.5);
+    REQUIRE(fRead.readDouble(d));
+    REQUIRE(d == -1000.0);
+    REQUIRE(fRead.readDouble(d));
+    REQUIRE(d == 2.25);
+
+    int64_t id = 0;
+    double value = 0;
+    std::string name;
+    int rows = 0;
+    while (fRead.parseColumns(id, value, name)) {
+        REQUIRE(id == rows);
+        REQUIRE(value == rows * 0.5);
+        REQUIRE(name == "name" + std::to_string(rows));
+        ++rows;
+    }
+    REQUIRE(rows == 2000);
+    REQUIRE_FALSE(fRead.readInt64(i));
+}
+
+TEST_CASE("Malformed numbers throw", "[File][Text]") {
+    removeFile(textFile);
+
+    {
+        TextWriter fWrite(textFile);
+        fWrite.writeString("12x\n99999999999999999999\n+-1234567890123456789012\n1\n");
+    }
+
+    TextReader fRead(textFile);
+    int64_t i = 0;
+    REQUIRE_THROWS_AS(fRead.readInt64(i), IOException);
+    fRead.readLine();
+    REQUIRE_THROWS_AS(fRead.readInt64(i), IOException);
+    fRead.readLine();
+    REQUIRE_THROWS_AS(fRead.readInt64(i), IOException); // second sign after '+'
+    fRead.readLine();
+    double a = 0, b = 0;
+    REQUIRE_THROWS_AS(fRead.parseColumns(a, b), IOException);
+
+    // Commas are single separators: an empty field is an error, not skipped
+    {
+        TextWriter fWrite(textFile);
+        fWrite.writeString("1 , 2\n1,,3\n,2,3\n1,,3\n");
+    }
+    TextReader columns(textFile);
+    int64_t x = 0, y = 0, z = 0;
+    REQUIRE(columns.parseColumns(x, y));
+    REQUIRE((x == 1 && y == 2));
+    REQUIRE_THROWS_AS(columns.parseColumns(x, y, z), IOException);
+    columns.readLine();
+    REQUIRE_THROWS_AS(columns.parseColumns(x, y, z), IOException);
+    columns.readLine();
+    REQUIRE(columns.readInt64(x));
+    REQUIRE_THROWS_AS(columns.readInt64(x), IOException);
+}
+
+#if SFIO_HAS_PRINT
+TEST_CASE("Formatted output", "[File][Text]") {
+    removeFile(textFile);
+
+    std::string expected;
+    {
+        TextWriter fWrite(textFile, false, MinBufferSize);
+        for (int i = 0; i < 1000; ++i) {
+            fWrite.println("{} {:.2f} {}", i, i * 0.5, "row");
+            expected += std::to_string(i) + " " + std::format("{:.2f}", i * 0.5) + " row\n";
+        }
+        std::string big(3 * MinBufferSize, 'x');
+        fWrite.print("{}|", big);
+        expected += big + "|";
+    }
+
+    TextReader fRead(textFile);
+    REQUIRE(fRead.readString() == expected);
+}
+#endif
+
+TEST_CASE("Number serialization", "[File][Text]") {
+    removeFile(textFile);
+
+    std::vector<double> column;
+    for (int i = 0; i < 5000; ++i)
+        column.push_back(i % 7 == 0 ? -1e-300 * i : i * 1.0 / 3.0);
+
+    {
+        TextWriter fWrite(textFile, false, MinBufferSize);
+        fWrite.writeInt(std::numeric_limits<int64_t>::min());
+        fWrite.writeString(" ");
+        fWrite.writeDouble(0.1);
+        fWrite.writeString(" ");
+        fWrite.writeFixed(2.0 / 3.0, 3);
+        fWrite.writeString("\n");
+        fWrite.writeColumn(column);
+        fWrite.writeFixed(1e300, 2);
+        REQUIRE_THROWS_AS(fWrite.writeFixed(1.0, -1), std::invalid_argument);
+    }
+
+    TextReader fRead(textFile);
+    REQUIRE(fRead.readLine() == "-9223372036854775808 0.1 0.667");
+    for (double expected : column) {
+        double value = 0;
+        REQUIRE(fRead.readDouble(value));
+        REQUIRE(value == expected);
+    }
+    REQUIRE(fRead.readLine().empty()); // rest of the last column line
+    std::string last = fRead.readLine();
+    REQUIRE(last.size() == 304);
+    REQUIRE(last.substr(0, 2) == "10");
+    REQUIRE(last.substr(last.size() - 3) == ".00");
+}
+
+#if defined(SFIO_HAVE_ZLIB) || defined(SFIO_HAVE_ZSTD) || defined(SFIO_HAVE_LZ4)
+namespace {
+    void checkCompressedRoundTrip(const std::string& path, Compression compression, const char* magic) {
+        removeFile(path);
+
+        std::string expected;
+        {
+            // Compression::Auto picks the codec from the extension
+            TextWriter fWrite(path, false, MinBufferSize, Compression::Auto);
+            for (int i = 0; i < 50000; ++i) {
+                std::string line = "record " + std::to_string(i) + " " + std::string(i % 50, 'a');
+                fWrite.writeLine(line);
+                expected += line + "\n";
+                if (i == 1000) fWrite.flush();
+            }
+        }
+        {
+            // Appending starts a second frame, decoded as one stream
+            TextWriter fWrite(path, true, DefaultBufferSize, compression);
+            fWrite.writeLine("appended");
+            expected += "appended\n";
+        }
+        REQUIRE(fs::file_size(path) < expected.size() / 4);
+
+        {
+            ByteReader raw(path);
+            auto bytes = raw.readBytes();
+            REQUIRE(std::memcmp(bytes.data(), magic, 2) == 0);
+        }
+        {
+            TextReader fRead(path, MinBufferSize, Compression::Auto);
+            REQUIRE(fRead.readString() == expected);
+        }
+        {
+            ByteReader fRead(path, DefaultBufferSize, compression);
+            auto bytes = fRead.readBytes();
+            REQUIRE(std::string(bytes.begin(), bytes.end()) == expected);
+        }
+
+        // Truncated input is reported, not silently cut short
+        fs::resize_file(path, fs::file_size(path) / 2);
+        TextReader truncated(path, MinBufferSize, compression);
+        REQUIRE_THROWS_AS(truncated.readLines(), IOException);
+    }
+}
+
+TEST_CASE("Compressed streams", "[File][Compression]") {
+#if defined(SFIO_HAVE_ZLIB)
+    checkCompressedRoundTrip("test.txt.gz", Compression::Gzip, "\x1f\x8b");
+#endif
+#if defined(SFIO_HAVE_ZSTD)
+    checkCompressedRoundTrip("test.txt.zst", Compression::Zstd, "\x28\xb5");
+#endif
+#if defined(SFIO_HAVE_LZ4)
+    checkCompressedRoundTrip("test.txt.lz4", Compression::Lz4, "\x04\x22");
+#endif
+
+    // Auto detection leaves plain files alone
+    removeFile(textFile);
+    {
+        TextWriter fWrite(textFile, false, DefaultBufferSize, Compression::Auto);
+        fWrite.writeLine("plain");
+    }
+    TextReader fRead(textFile, DefaultBufferSize, Compression::Auto);
+    REQUIRE(fRead.readLine() == "plain");
+}
+#endif
+
+TEST_CASE("Block container random access and parallel decode", "[File][Binary][Compression]") {
+    const std::string blockFile = "blocks.sfb";
+
+    std::vector<char> data;
+    for (int i = 0; i < 400000; ++i) {
+        std::string record = std::to_string(i * 7919LL % 100003) + (i % 3 ? "," : "\n");
+        data.insert(data.end(), record.begin(), record.end());
+    }
+    for (int i = 0; i < 20000; ++i) data.push_back(static_cast<char>(i * 2654435761u >> 24)); // incompressible tail
+
+    for (Compression codec : {Compression::None, Compression::Auto}) {
+        removeFile(blockFile);
+        {
+            BlockWriter fWrite(blockFile, codec, 16 << 10);
+            fWrite.write(std::span<const char>(data.data(), 1000));
+            fWrite.flush(); // short block
+            fWrite.write(std::span<const char>(data.data() + 1000, data.size() - 1000));
+        }
+
+        BlockReader fRead(blockFile);
+        REQUIRE(fRead.size() == data.size());
+        REQUIRE(fRead.blockCount() > 2);
+        REQUIRE(fRead.readBytes(4) == data);
+
+        // Sequential reads in odd-sized chunks
+        std::vector<char> chunk(5000), sequential;
+        while (size_t got = fRead.read(chunk))
+            sequential.insert(sequential.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(got));
+        REQUIRE(sequential == data);
+
+        // Random access across block boundaries
+        for (uint64_t offset : {uint64_t(0), uint64_t(999), uint64_t(16383), uint64_t(17384), uint64_t(data.size() - 10)}) {
+            std::vector<char> window(3000);
+            size_t got = fRead.readAt(offset, window);
+            REQUIRE(got == std::min<size_t>(3000, data.size() - offset));
+            REQUIRE(std::equal(window.begin(), window.begin() + static_cast<std::ptrdiff_t>(got),
+                               data.begin() + static_cast<std::ptrdiff_t>(offset)));
+        }
+
+        std::atomic<uint64_t> covered{0};
+        std::atomic<bool> matches{true};
+        fRead.forEachBlock([&](uint64_t offset, std::string_view block) {
+            covered += block.size();
+            if (block != std::string_view(data.data() + offset, block.size())) matches = false;
+        });
+        REQUIRE(covered == data.size());
+        REQUIRE(matches);
+    }
+
+    REQUIRE_THROWS_AS(BlockReader(textFile), IOException);
+}
+
+TEST_CASE("Inline checksums and trailers", "[File][Binary][Checksum]") {
+    std::vector<char> data;
+    for (int r = 0; r < 3; ++r)
+        for (int i = 0; i < 256; ++i) data.push_back(static_cast<char>(i));
+    data.insert(data.end(), {'x', 'y', 'z'});
+
+    // Whichever CRC32C kernel the CPU selects agrees with the portable tables
+    for (size_t n : {size_t(0), size_t(1), size_t(7), size_t(8), size_t(9), data.size()})
+        REQUIRE(detail::crc32cUpdate(~0u, data.data(), n)
+                == detail::crc32cSoftware(~0u, reinterpret_cast<const unsigned char*>(data.data()), n));
+
+    for (auto [kind, expected] : {std::pair{Checksum::Crc32c, uint64_t(0x665d3f04)},
+                                  std::pair{Checksum::XxHash64, uint64_t(0xe921a1b45bd779f8)}}) {
+        removeFile(binaryFile);
+        {
+            ByteWriter fWrite(binaryFile, false, MinBufferSize, Compression::None, kind);
+            fWrite.writeBytes(std::vector<char>(data.begin(), data.begin() + 5));
+            fWrite.writeBytes(std::vector<char>(data.begin() + 5, data.end()));
+            fWrite.flush();
+            REQUIRE(fWrite.checksum() == expected);
+        }
+        {
+            ByteReader fRead(binaryFile, DefaultBufferSize, Compression::None, kind);
+            REQUIRE(fRead.readBytes() == data);
+            REQUIRE(fRead.checksum() == expected);
+        }
+
+        // With a trailer the digest follows the data and is verified at EOF
+        {
+            ByteWriter fWrite(binaryFile, false, MinBufferSize, Compression::None, kind, true);
+            fWrite.writeBytes(data);
+            fWrite.close();
+        }
+        REQUIRE(fs::file_size(binaryFile) == data.size() + (kind == Checksum::Crc32c ? 4 : 8));
+        {
+            ByteReader fRead(binaryFile, DefaultBufferSize, Compression::None, kind, true);
+            REQUIRE(fRead.readBytes() == data);
+            REQUIRE(fRead.checksum() == expected);
+        }
+        {
+            // Reads smaller than the trailer
+            ByteReader fRead(binaryFile, MinBufferSize, Compression::None, kind, true);
+            std::vector<char> chunk(3), got;
+            while (size_t n = fRead.read(chunk)) got.insert(got.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(n));
+            REQUIRE(got == data);
+        }
+
+        // A flipped byte is caught when EOF is reached
+        {
+            ByteReader raw(binaryFile);
+            auto bytes = raw.readBytes();
+            bytes[100] ^= 1;
+            ByteWriter fWrite(binaryFile);
+            fWrite.writeBytes(bytes);
+        }
+        ByteReader corrupt(binaryFile, DefaultBufferSize, Compression::None, kind, true);
+        REQUIRE_THROWS_AS(corrupt.readBytes(), IOException);
+    }
+
+    removeFile(textFile);
+    {
+        TextWriter fWrite(textFile, false, DefaultBufferSize, Compression::None, Checksum::Crc32c, true);
+        fWrite.writeString("123456789");
+    }
+    TextReader fRead(textFile, DefaultBufferSize, Compression::None, Checksum::Crc32c, true);
+    REQUIRE(fRead.readLine() == "123456789");
+    REQUIRE(fRead.checksum() == 0xe3069283);
+}
+
+TEST_CASE("Follow mode waits for appended lines and rotation", "[File][Text][Follow]") {
+    const std::string rotated = textFile + ".1";
+    removeFile(textFile);
+    removeFile(rotated);
+    auto appendRaw = [](const std::string& path, const std::string& data) {
+        TextWriter fWrite(path, true);
+        fWrite.writeString(data);
+    };
+
+    appendRaw(textFile, "a\nb");
+    TextReader fRead(textFile, DefaultBufferSize, Compression::None, Checksum::Crc32c);
+    fRead.setFollow(true, 50);
+
+    std::string line;
+    REQUIRE(fRead.readLine(line));
+    REQUIRE(line == "a");
+    REQUIRE_FALSE(fRead.readLine(line)); // times out; "b" is held back
+
+    appendRaw(textFile, "c\n");
+    REQUIRE(fRead.readLine(line));
+    REQUIRE(line == "bc");
+
+    // Blocks until another thread appends
+    fRead.setFollow(true);
+    std::thread writer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        appendRaw(textFile, "d\n");
+    });
+    REQUIRE(fRead.readLine(line));
+    REQUIRE(line == "d");
+    writer.join();
+
+    // Rename + recreate: finish the old file, then read the new one
+    appendRaw(textFile, "old-partial");
+    fs::rename(textFile, rotated);
+    appendRaw(textFile, "new\n");
+    fRead.setFollow(true, 2000);
+    REQUIRE(fRead.readLine() == "old-partial");
+    REQUIRE(fRead.readLine() == "new");
+
+    // Truncation starts over at the beginning
+    { TextWriter fWrite(textFile); fWrite.writeString("t\n"); }
+    REQUIRE(fRead.readLine() == "t");
+
+    fRead.setFollow(false);
+    REQUIRE_FALSE(fRead.readLine(line));
+
+    // The checksum spans every file the reader went through
+    { TextWriter fWrite(rotated); fWrite.writeString("a\nbc\nd\nold-partialnew\nt\n"); }
+    TextReader whole(rotated, DefaultBufferSize, Compression::None, Checksum::Crc32c);
+    whole.readString();
+    REQUIRE(fRead.checksum() == whole.checksum());
+    removeFile(rotated);
+}
+
+TEST_CASE("Line index random access", "[File][Text][Index]") {
+    const std::string indexFile = "test.txt.idx";
+    removeFile(textFile);
+    removeFile(indexFile);
+
+    std::vector<std::string> lines;
+    {
+        TextWriter fWrite(textFile);
+        for (int i = 0; i < 30000; ++i) {
+            lines.push_back(i % 11 == 0 ? "" : "line " + std::to_string(i) + std::string(i % 300, '.') + (i % 5 ? "" : "\r"));
+            fWrite.writeLine(lines.back());
+        }
+        fWrite.writeString("unterminated");
+        lines.push_back("unterminated");
+    }
+
+    LineIndex built = LineIndex::build(textFile, '\n', 4);
+    REQUIRE(built.lineCount() == lines.size());
+    REQUIRE(built.fileSize() == fs::file_size(textFile));
+
+    built.save(indexFile);
+    REQUIRE(fs::file_size(indexFile) < fs::file_size(textFile) / 50);
+    LineIndex index = LineIndex::load(indexFile);
+    REQUIRE(index.lineCount() == built.lineCount());
+    REQUIRE(index.lineStart(12345) == built.lineStart(12345));
+
+    TextReader fRead(textFile, MinBufferSize);
+    for (size_t n : {size_t(29000), size_t(17), size_t(18), size_t(0), size_t(30000)}) {
+        fRead.seekLine(index, n);
+        REQUIRE(fRead.readLine() == lines[n]);
+    }
+    fRead.seekLine(index, index.lineCount());
+    std::string line;
+    REQUIRE_FALSE(fRead.readLine(line));
+    REQUIRE_THROWS_AS(fRead.seekLine(index, index.lineCount() + 1), std::out_of_range);
+
+    auto range = fRead.readLineRange(index, 29990, 30001);
+    REQUIRE(range == std::vector<std::string>(lines.begin() + 29990, lines.end()));
+    fRead.setStripCR(true);
+    REQUIRE(fRead.readLineRange(index, 5, 6).front() == "line 5.....");
+
+    // An index is only valid for the delimiter it was built with
+    fRead.setDelimiter(';');
+    REQUIRE_THROWS_AS(fRead.seekLine(index, 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(fRead.readLineRange(index, 0, 1), std::invalid_argument);
+    fRead.setDelimiter("\r\n");
+    REQUIRE_THROWS_AS(fRead.seekLine(index, 1), std::invalid_argument);
+
+    // Trailing delimiter ends the last line
+    { TextWriter fWrite(textFile); fWrite.writeString("a\n\nb\n"); }
+    REQUIRE(LineIndex::build(textFile).lineCount() == 3);
+
+    { TextWriter fWrite(indexFile); fWrite.writeString("garbage"); }
+    REQUIRE_THROWS_AS(LineIndex::load(indexFile), IOException);
+    removeFile(indexFile);
+}
+
+TEST_CASE("Reverse line reading and tail", "[File][Text][Reverse]") {
+    removeFile(textFile);
+
+    std::vector<std::string> lines;
+    {
+        TextWriter fWrite(textFile);
+        for (int i = 0; i < 3000; ++i) {
+            lines.push_back(i % 7 == 0 ? "" : "entry " + std::to_string(i) + std::string(i % 5000, '-'));
+            fWrite.writeLine(lines.back());
+        }
+    }
+
+    {
+        // Small blocks: lines span several of them
+        ReverseTextReader fRead(textFile, MinBufferSize);
+        std::vector<std::string> reversed;
+        for (std::string line; fRead.readLine(line); ) reversed.push_back(line);
+        std::reverse(reversed.begin(), reversed.end());
+        REQUIRE(reversed == lines);
+        REQUIRE(fRead.readLine().empty());
+    }
+
+    REQUIRE(ReverseTextReader(textFile).tail(3) == std::vector<std::string>(lines.end() - 3, lines.end()));
+
+    { TextWriter fWrite(textFile); fWrite.writeString("\nfirst\r\nlast"); }
+    ReverseTextReader fRead(textFile);
+    fRead.setStripCR(true);
+    REQUIRE(fRead.tail(10) == std::vector<std::string>{"", "first", "last"});
+
+    // A '\r' ending an unterminated last line is data, as for TextReader
+    { TextWriter fWrite(textFile); fWrite.writeString("first\r\nlast\r"); }
+    TextReader forward(textFile);
+    forward.setStripCR(true);
+    ReverseTextReader backward(textFile);
+    backward.setStripCR(true);
+    REQUIRE(backward.tail(10) == forward.readLines());
+
+    { TextWriter fWrite(textFile); }
+    std::string line;
+    REQUIRE_FALSE(ReverseTextReader(textFile).readLine(line));
+
+    removeFile(textFile);
+    try {
+        ReverseTextReader missing(textFile);
+        FAIL("Expected IOException for FileNotFound");
+    } catch (const IOException& e) {
+        REQUIRE(e.code == IOError::FileNotFound);
+    }
+}
+
+TEST_CASE("Seek, tell, skip and positional reads", "[File][Seek]") {
+    removeFile(binaryFile);
+    std::vector<char> data(100000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i * 31 % 251);
+    { ByteWriter fWrite(binaryFile); fWrite.writeBytes(data); }
+
+    {
+        ByteReader fRead(binaryFile, MinBufferSize);
+        std::vector<char> chunk(100);
+        REQUIRE(fRead.read(chunk) == 100);
+        REQUIRE(fRead.tell() == 100);
+
+        fRead.seek(10); // still buffered
+        REQUIRE(fRead.read(chunk) == 100);
+        REQUIRE(std::equal(chunk.begin(), chunk.end(), data.begin() + 10));
+
+        fRead.seek(90000); // outside the buffer
+        REQUIRE(fRead.tell() == 90000);
+        REQUIRE(fRead.read(chunk) == 100);
+        REQUIRE(std::equal(chunk.begin(), chunk.end(), data.begin() + 90000));
+
+        fRead.skip(9800);
+        REQUIRE(fRead.read(chunk) == 100);
+        REQUIRE(fRead.tell() == data.size());
+        REQUIRE(fRead.read(chunk) == 0);
+
+        // Positional reads do not move the cursor
+        std::vector<char> window(50);
+        REQUIRE(fRead.readAt(500, window) == 50);
+        REQUIRE(std::equal(window.begin(), window.end(), data.begin() + 500));
+        REQUIRE(fRead.readAt(data.size() - 20, window) == 20);
+        REQUIRE(fRead.tell() == data.size());
+    }
+
+    removeFile(textFile);
+    { TextWriter fWrite(textFile); fWrite.writeString("alpha\nbeta\ngamma\n"); }
+    TextReader fRead(textFile);
+    REQUIRE(fRead.readLine() == "alpha");
+    REQUIRE(fRead.tell() == 6);
+    fRead.skip(5);
+    REQUIRE(fRead.readLine() == "gamma");
+    fRead.seek(0);
+    REQUIRE(fRead.readLine() == "alpha");
+    std::string word(4, '\0');
+    REQUIRE(fRead.readAt(6, word) == 4);
+    REQUIRE(word == "beta");
+    REQUIRE(fRead.readLine() == "beta");
+}
+
+TEST_CASE("Multi-pattern file search", "[File][Text][Search]") {
+    removeFile(textFile);
+
+    std::vector<std::string> lines;
+    {
+        TextWriter fWrite(textFile);
+        for (int i = 0; i < 20000; ++i) {
+            std::string line = "event " + std::to_string(i) + std::string(i % 90, ' ');
+            if (i % 997 == 0) line += "ERROR disk";
+            if (i % 1999 == 0) line += " timeout";
+            lines.push_back(line);
+            fWrite.writeLine(line);
+        }
+        fWrite.writeString("last ERROR"); // unterminated
+        lines.push_back("last ERROR");
+    }
+
+    std::vector<SearchMatch> expected;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        size_t error = lines[i].find("ERROR"), timeout = lines[i].find("timeout");
+        if (error != std::string::npos || timeout != std::string::npos)
+            expected.push_back({i, offset, timeout < error ? size_t(1) : size_t(0), lines[i]});
+        offset += lines[i].size() + 1;
+    }
+
+    auto matches = searchFile(textFile, {"ERROR", "timeout"}, 4);
+    REQUIRE(matches.size() == expected.size());
+    for (size_t i = 0; i < matches.size(); ++i) {
+        REQUIRE(matches[i].line == expected[i].line);
+        REQUIRE(matches[i].offset == expected[i].offset);
+        REQUIRE(matches[i].pattern == expected[i].pattern);
+        REQUIRE(matches[i].text == expected[i].text);
+    }
+
+    REQUIRE(searchFile(textFile, "event 19999").size() == 1);
+    REQUIRE(searchFile(textFile, "absent").empty());
+    REQUIRE_THROWS_AS(searchFile(textFile, ""), std::invalid_argument);
+
+    // Several scan chunks, with one line longer than a chunk crossing two
+    // chunk boundaries
+    {
+        TextWriter fWrite(textFile);
+        for (int i = 0; i < 1000000; ++i) fWrite.writeLine("row " + std::to_string(i) + (i % 5003 == 0 ? " ERROR" : ""));
+        fWrite.writeLine(std::string(20 << 20, 'x') + "ERROR");
+        fWrite.writeLine("after ERROR");
+    }
+    matches = searchFile(textFile, "ERROR", 4);
+    REQUIRE(matches.size() == 1000000 / 5003 + 1 + 2);
+    for (size_t i = 0; i + 2 < matches.size(); ++i) {
+        REQUIRE(matches[i].line == i * 5003);
+        REQUIRE(matches[i].text == "row " + std::to_string(i * 5003) + " ERROR");
+    }
+    REQUIRE(matches[matches.size() - 2].line == 1000000);
+    REQUIRE(matches[matches.size() - 2].text.size() == (20 << 20) + 5);
+    REQUIRE(matches.back().line == 1000001);
+    REQUIRE(matches.back().offset == std::filesystem::file_size(textFile) - 12);
+    REQUIRE(matches.back().text == "after ERROR");
+
+    // Short lines fit each chunk's buffer: nothing grows past ScanChunk
+    {
+        TextWriter fWrite(textFile);
+        for (int i = 0; i < 300000; ++i) fWrite.writeLine(std::string(99, char('a' + i % 26)));
+    }
+    largestAllocation = 0;
+    auto [size, lengths] = detail::scanLineChunks<size_t, CountingAllocator<char>>(textFile, 1,
+        [](uint64_t, const char*, size_t length) { return length; });
+    REQUIRE(lengths.size() > 3);
+    REQUIRE(std::accumulate(lengths.begin(), lengths.end(), uint64_t(0)) == size);
+    REQUIRE(largestAllocation <= detail::ScanChunk);
+}
+
+TEST_CASE("Line counting and file stats", "[File][Text][Count]") {
+    removeFile(textFile);
+    {
+        TextWriter fWrite(textFile);
+        for (int i = 0; i < 5000; ++i) fWrite.writeLine(std::string(i % 300, 'x'));
+    }
+    REQUIRE(countLines(textFile, 4) == 5000);
+    FileStats info = stats(textFile, 4);
+    REQUIRE(info.lines == 5000);
+    REQUIRE(info.bytes == std::filesystem::file_size(textFile));
+    REQUIRE(info.longestLine == 299);
+
+    {
+        TextWriter fWrite(textFile, true);
+        fWrite.writeString(std::string(400, 'y')); // unterminated
+    }
+    REQUIRE(countLines(textFile) == 5001);
+    info = stats(textFile);
+    REQUIRE(info.lines == 5001);
+    REQUIRE(info.longestLine == 400);
+
+    removeFile(textFile);
+    { TextWriter fWrite(textFile); }
+    REQUIRE(countLines(textFile) == 0);
+    REQUIRE(stats(textFile).longestLine == 0);
+    REQUIRE_THROWS_AS(countLines("missing_count.txt"), IOException);
+}
+
+TEST_CASE("External merge sort", "[File][Text][Sort]") {
+    removeFile(textFile);
+    const std::string sortedFile = "sorted_output.txt";
+
+    std::vector<std::string> lines;
+    {
+        TextWriter fWrite(textFile);
+        uint64_t state = 12345;
+        for (int i = 0; i < 20000; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            std::string line = std::to_string(state >> 40) + std::string(state % 50, 'k');
+            lines.push_back(line);
+            fWrite.writeLine(line);
+        }
+    }
+    std::vector<std::string> expected = lines;
+    std::sort(expected.begin(), expected.end());
+
+    // A 64 KB budget forces dozens of runs and several merge passes
+    REQUIRE(externalSort(textFile, sortedFile, std::less<>{}, 64 << 10, 4) == lines.size());
+    REQUIRE(TextReader(sortedFile).readLines() == expected);
+
+    // Fits in memory: merged straight from the sorted slices
+    auto byLength = [](std::string_view a, std::string_view b) {
+        return a.size() != b.size() ? a.size() > b.size() : a < b;
+    };
+    REQUIRE(externalSort(textFile, sortedFile, byLength) == lines.size());
+    std::sort(expected.begin(), expected.end(), byLength);
+    REQUIRE(TextReader(sortedFile).readLines() == expected);
+
+    for (const auto& entry : std::filesystem::directory_iterator("."))
+        REQUIRE(entry.path().filename().string().find(".sort-") == std::string::npos);
+
+    removeFile(textFile);
+    { TextWriter fWrite(textFile); }
+    REQUIRE(externalSort(textFile, sortedFile) == 0);
+    REQUIRE(std::filesystem::file_size(sortedFile) == 0);
+    REQUIRE_THROWS_AS(externalSort(textFile, sortedFile, std::less<>{}, 1024), std::invalid_argument);
+    removeFile(sortedFile);
+}
+
+TEST_CASE("Rotating writer", "[File][Text][Rotate]") {
+    const std::string logFile = "rotate.log";
+    auto cleanup = [&] {
+        for (const auto& entry : fs::directory_iterator("."))
+            if (entry.path().filename().string().starts_with(logFile)) fs::remove(entry.path());
+    };
+    cleanup();
+
+    {
+        RotatingTextWriter log(logFile, 1000);
+        for (int i = 0; i < 100; ++i) log.writeLine("entry " + std::to_string(i) + std::string(40, '.'));
+        REQUIRE(log.size() <= 1000);
+        log.close();
+    }
+    // Segments hold whole lines, in order, and none exceeds the limit
+    std::vector<std::string> all;
+    int segments = 0;
+    for (int n = 1; fs::exists(logFile + "." + std::to_string(n)); segments = n++) {
+        std::string segment = logFile + "." + std::to_string(n);
+        REQUIRE(fs::file_size(segment) <= 1000);
+        for (auto& line : TextReader(segment).readLines()) all.push_back(line);
+    }
+    for (auto& line : TextReader(logFile).readLines()) all.push_back(line);
+    REQUIRE(all.size() == 100);
+    for (int i = 0; i < 100; ++i) REQUIRE(all[i] == "entry " + std::to_string(i) + std::string(40, '.'));
+
+    // New segments continue after the highest existing one, even with a gap
+    // left by a deleted segment; manual rotation
+    REQUIRE(segments >= 4);
+    fs::remove(logFile + ".2");
+    {
+        RotatingTextWriter log(logFile, 0);
+        log.writeLine("more");
+        log.rotate();
+        log.rotate(); // empty: no segment
+        log.writeLine("last");
+    }
+    REQUIRE_FALSE(fs::exists(logFile + ".2"));
+    const std::string next = logFile + "." + std::to_string(segments + 1);
+    REQUIRE(TextReader(next).readString().ends_with("more\n"));
+    REQUIRE_FALSE(fs::exists(logFile + "." + std::to_string(segments + 2)));
+    REQUIRE(TextReader(logFile).readString() == "last\n");
+
+#if defined(SFIO_HAVE_ZLIB)
+    cleanup();
+    {
+        RotatingTextWriter log(logFile, 4096, std::chrono::seconds::zero(), Compression::Gzip);
+        for (int i = 0; i < 2000; ++i) log.writeLine("compressed " + std::to_string(i));
+        log.close(); // waits for the background compression
+    }
+    REQUIRE(fs::exists(logFile + ".1.gz"));
+    REQUIRE_FALSE(fs::exists(logFile + ".1"));
+    uint64_t lines = 0;
+    for (int n = 1; fs::exists(logFile + "." + std::to_string(n) + ".gz"); ++n)
+        lines += TextReader(logFile + "." + std::to_string(n) + ".gz", DefaultBufferSize, Compression::Auto).readLines().size();
+    REQUIRE(lines + TextReader(logFile).readLines().size() == 2000);
+#endif
+    REQUIRE_THROWS_AS(RotatingTextWriter(logFile, 10, std::chrono::seconds::zero(), Compression::Auto), std::invalid_argument);
+    cleanup();
+}
+
+TEST_CASE("Sharded writer", "[File][Text][Shard]") {
+    const std::string outFile = "sharded.txt";
+    removeFile(outFile);
+
+    std::vector<std::string> expected;
+    {
+        ShardedWriter out(outFile, 4);
+        REQUIRE(out.shardCount() == 4);
+
+        // One shard per thread, no locking
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < out.shardCount(); ++t)
+            workers.emplace_back([&out, t] {
+                for (int i = 0; i < 5000; ++i) out.shard(t).writeLine("t" + std::to_string(t) + " " + std::to_string(i));
+            });
+        for (auto& worker : workers) worker.join();
+        for (size_t t = 0; t < 4; ++t)
+            for (int i = 0; i < 5000; ++i) expected.push_back("t" + std::to_string(t) + " " + std::to_string(i));
+
+        uint64_t joined = out.concatenate(outFile);
+        REQUIRE(joined == fs::file_size(outFile));
+        REQUIRE_FALSE(fs::exists(out.shardPath(0)));
+    }
+    // Shards keep per-thread order and are joined in shard order
+    REQUIRE(TextReader(outFile).readLines() == expected);
+
+    {
+        ShardedWriter out(outFile, 3);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t)
+            workers.emplace_back([&out, t] {
+                for (int i = 0; i < 1000; ++i) {
+                    std::string key = "key" + std::to_string(i % 10);
+                    out.writeLine(key, key);
+                    out.writeLine("rr " + std::to_string(t));
+                }
+            });
+        for (auto& worker : workers) worker.join();
+        out.close();
+
+        uint64_t total = 0;
+        for (size_t s = 0; s < out.shardCount(); ++s) {
+            for (const auto& line : TextReader(out.shardPath(s)).readLines()) {
+                ++total;
+                if (line.starts_with("key")) REQUIRE(out.shardFor(line) == s);
+            }
+            removeFile(out.shardPath(s));
+        }
+        REQUIRE(total == 8000);
+    }
+    removeFile(outFile);
+}
+
+TEST_CASE("Page-cache residency and prefetch", "[File][Cache]") {
+    removeFile(binaryFile);
+    {
+        ByteWriter fWrite(binaryFile);
+        std::vector<char> data(1 << 20, 'p');
+        fWrite.writeBytes(data);
+    }
+
+    TextReader::prefetch(binaryFile);
+    ByteReader::prefetch(binaryFile, 4096, 65536);
+    ByteReader::prefetch(binaryFile, 10 << 20); // past EOF: nothing to do
+    REQUIRE(ByteReader(binaryFile).readBytes().size() == 1 << 20);
+    double fraction = ByteReader::cachedFraction(binaryFile);
+#if defined(__linux__)
+    REQUIRE(fraction > 0.0); // just read back, so at least partly resident
+#endif
+    REQUIRE(fraction <= 1.0);
+
+    removeFile(binaryFile);
+    { ByteWriter fWrite(binaryFile); }
+    REQUIRE(TextReader::cachedFraction(binaryFile) == 1.0);
+    removeFile(binaryFile);
+    REQUIRE_THROWS_AS(TextReader::cachedFraction(binaryFile), IOException);
+    REQUIRE_THROWS_AS(ByteReader::prefetch(binaryFile), IOException);
 }